@@ -1,6 +1,7 @@
 #!/bin/bash
 
 #usage : hipconvertinplace-perl.sh DIRNAME [hipify-perl options]
+# e.g.  : hipconvertinplace-perl.sh DIRNAME -j=8   (hipify files with 8 parallel jobs)
 
 #hipify "inplace" all code files in specified directory.
 # This can be quite handy when dealing with an existing CUDA code base since the script
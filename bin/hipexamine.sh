@@ -5,7 +5,6 @@
 # Generate CUDA->HIP conversion statistics for all the code files in the specified directory.
 
 SCRIPT_DIR=`dirname $0`
-PRIV_SCRIPT_DIR="$SCRIPT_DIR/../libexec/hipify"
 SEARCH_DIR=$1
 
 hipify_args=''
@@ -20,4 +19,4 @@ while (( "$#" )); do
 done
 clang_args="$@"
 
-$SCRIPT_DIR/hipify-clang -examine $hipify_args `$PRIV_SCRIPT_DIR/findcode.sh $SEARCH_DIR` -- -x cuda $clang_args
+$SCRIPT_DIR/hipify-clang -examine $hipify_args -dir="$SEARCH_DIR" -- -x cuda $clang_args
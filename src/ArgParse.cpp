@@ -21,6 +21,9 @@ THE SOFTWARE.
 */
 
 #include "ArgParse.h"
+#include "clang/Tooling/CommonOptionsParser.h"
+
+namespace ct = clang::tooling;
 
 cl::OptionCategory ToolTemplateCategory("CUDA to HIP source translator options");
 
@@ -29,7 +32,8 @@ cl::opt<std::string> OutputFilename("o",
   cl::value_desc("filename"),
   cl::cat(ToolTemplateCategory));
 
-cl::opt<std::string> OutputDir("o-dir",
+cl::opt<std::string, true> OutputDirOption("o-dir",
+  cl::location(OutputDir),
   cl::desc("Output directory"),
   cl::value_desc("directory"),
   cl::cat(ToolTemplateCategory));
@@ -39,17 +43,25 @@ cl::opt<bool> GeneratePerl("perl",
   cl::value_desc("perl"),
   cl::cat(ToolTemplateCategory));
 
+cl::opt<bool, true> GeneratePerlModulesOption("perl-modules",
+  cl::location(GeneratePerlModules),
+  cl::desc("Generate hipify-perl as a driver script and per-API modules, which are loaded only for the sources using the API (with --perl)"),
+  cl::value_desc("perl-modules"),
+  cl::cat(ToolTemplateCategory));
+
 cl::opt<bool> GeneratePython("python",
   cl::desc("Generate hipify-python"),
   cl::value_desc("python"),
   cl::cat(ToolTemplateCategory));
 
-cl::opt<std::string> OutputHipifyPerlDir("o-hipify-perl-dir",
+cl::opt<std::string, true> OutputHipifyPerlDirOption("o-hipify-perl-dir",
+  cl::location(OutputHipifyPerlDir),
   cl::desc("Output directory for hipify-perl script"),
   cl::value_desc("directory"),
   cl::cat(ToolTemplateCategory));
 
-cl::opt<std::string> OutputPythonMapDir("o-python-map-dir",
+cl::opt<std::string, true> OutputPythonMapDirOption("o-python-map-dir",
+  cl::location(OutputPythonMapDir),
   cl::desc("Output directory for Python map"),
   cl::value_desc("directory"),
   cl::cat(ToolTemplateCategory));
@@ -64,7 +76,8 @@ cl::opt<std::string> CudaPath("cuda-path",
   cl::value_desc("directory"),
   cl::cat(ToolTemplateCategory));
 
-cl::opt<bool> SaveTemps("save-temps",
+cl::opt<bool, true> SaveTempsOption("save-temps",
+  cl::location(SaveTemps),
   cl::desc("Save temporary files"),
   cl::value_desc("save-temps"),
   cl::cat(ToolTemplateCategory));
@@ -74,15 +87,16 @@ cl::opt<bool> Verbose("v",
   cl::value_desc("v"),
   cl::cat(ToolTemplateCategory));
 
-cl::opt<bool> TranslateToRoc("roc",
+cl::opt<bool, true> TranslateToRocOption("roc",
+  cl::location(TranslateToRoc),
   cl::desc("Translate to roc instead of hip where it is possible"),
   cl::value_desc("roc"),
   cl::cat(ToolTemplateCategory));
 
-cl::opt<bool> TranslateToMIOpen("miopen",
+cl::opt<bool, true> TranslateToMIOpenOption("miopen",
+  cl::location(TranslateToMIOpen),
   cl::desc("Translate to miopen instead of hip where it is possible"),
   cl::value_desc("miopen"),
-  cl::init(false),
   cl::cat(ToolTemplateCategory));
 
 cl::opt<bool> Inplace("inplace",
@@ -115,6 +129,21 @@ cl::opt<std::string> OutputStatsFilename("o-stats",
   cl::value_desc("filename"),
   cl::cat(ToolTemplateCategory));
 
+cl::opt<std::string> StatsFormat("stats-format",
+  cl::desc("Format of the statistics file: 'csv' (default) or 'jsonl' (a JSON record per file streamed as soon as the file is processed,\nfollowed by an aggregate record for multiple source files)"),
+  cl::value_desc("value"),
+  cl::cat(ToolTemplateCategory));
+
+cl::opt<bool> PrintPerfCounters("print-perf-counters",
+  cl::desc("Print hot path counters: tokens lexed, rename lookups and hits by API, string literals scanned,\nmatcher callbacks and replacements inserted or rejected;\nthey go into the statistics file if it is requested, and to the terminal otherwise or along with -print-stats"),
+  cl::value_desc("print-perf-counters"),
+  cl::cat(ToolTemplateCategory));
+
+cl::opt<std::string> MetricsFilename("metrics-file",
+  cl::desc("Output filename for run metrics in OpenMetrics text format (e.g. for node-exporter textfile collector);\nthe file is refreshed during the run and finally written at the end of it"),
+  cl::value_desc("filename"),
+  cl::cat(ToolTemplateCategory));
+
 cl::opt<bool> Examine("examine",
   cl::desc("Combines -no-output and -print-stats options"),
   cl::value_desc("examine"),
@@ -161,7 +190,8 @@ cl::opt<bool> GenerateCSV("csv",
   cl::value_desc("csv"),
   cl::cat(ToolTemplateCategory));
 
-cl::opt<std::string> DocFormat("doc-format",
+cl::opt<std::string, true> DocFormatOption("doc-format",
+  cl::location(DocFormat),
   cl::desc("Documentation format: 'full' (default), 'strict', or 'compact';\n'--md' or '--csv' option should be specified"),
   cl::value_desc("value"),
   cl::cat(ToolTemplateCategory));
@@ -182,33 +212,124 @@ cl::opt<bool> HipKernelExecutionSyntax("hip-kernel-execution-syntax",
   cl::value_desc("hip-kernel-execution-syntax"),
   cl::cat(ToolTemplateCategory));
 
+cl::opt<bool> Hybrid("hybrid",
+  cl::desc("Hipify by the lexical engine the files, which don't contain constructs needing the AST (kernel launches,\ncalls of functions with argument casts, cub namespace uses); hipify the rest by clang; report the engine per file"),
+  cl::value_desc("hybrid"),
+  cl::cat(ToolTemplateCategory));
+
+cl::opt<std::string> SourceDir("dir",
+  cl::desc("Hipify all the source files in the directory tree: the files are hipified while the tree is being walked;\nwith -o-dir the directory structure is mirrored in the output directory"),
+  cl::value_desc("directory"),
+  cl::cat(ToolTemplateCategory));
+
+cl::list<std::string> SourceDirExtensions("dir-ext",
+  cl::desc("Comma-separated case-insensitive extensions of the source files to hipify with -dir\n(default: cu,cuh,cpp,cxx,cc,c,h,hpp,hxx,inc,inl,hdl)"),
+  cl::value_desc("extensions"),
+  cl::CommaSeparated,
+  cl::cat(ToolTemplateCategory));
+
+cl::list<std::string> SourceDirIgnore("dir-ignore",
+  cl::desc("Comma-separated wildcard patterns ('*', '?') of the files and directories to skip with -dir;\na pattern is matched against the name and the path relative to the directory"),
+  cl::value_desc("patterns"),
+  cl::CommaSeparated,
+  cl::cat(ToolTemplateCategory));
+
+cl::opt<std::string> FilesFrom("files-from",
+  cl::desc("Hipify the source files listed in the file (\"-\" for stdin) separated by newlines or, if the list contains\nany NUL character, by NULs (find -print0); the files are hipified while the list is being read"),
+  cl::value_desc("file"),
+  cl::cat(ToolTemplateCategory));
+
+cl::opt<unsigned> PerFileTimeout("per-file-timeout",
+  cl::desc("Hipify each file by clang in a worker process, which is killed after the number of seconds;\nthe file is then reported as timed out (0 - no time limit, by default)"),
+  cl::value_desc("seconds"),
+  cl::init(0),
+  cl::cat(ToolTemplateCategory));
+
+cl::opt<bool> TimeoutLexicalRetry("timeout-lexical-retry",
+  cl::desc("Hipify the files, which hipification by clang timed out on (-per-file-timeout), by the lexical engine"),
+  cl::value_desc("timeout-lexical-retry"),
+  cl::cat(ToolTemplateCategory));
+
+cl::opt<std::string> MappingOverlay("mapping-overlay",
+  cl::desc("Load the additional CUDA to HIP mappings from the tab-separated file with the lines:\n<CUDA name> <HIP name> <conversion type> <API type> [<ROC name>];\nthe mappings take precedence over the built-in ones, also in the generated hipify-perl and Python map"),
+  cl::value_desc("file"),
+  cl::cat(ToolTemplateCategory));
+
+cl::opt<std::string> MappingDatabase("mapping-db",
+  cl::desc("Look the CUDA identifiers up in the binary mapping database, generated by hipify-tables, which is mapped into memory\ninstead of building the maps; the database is shared by all the processes, which use it;\nit is ignored if --cuda-version or --hip-version is specified"),
+  cl::value_desc("file"),
+  cl::cat(ToolTemplateCategory));
+
+cl::opt<bool> IncludeDrivenRenames("include-driven-renames",
+  cl::desc("Look up the identifiers of the CUDA Driver and Runtime APIs, and of only those CUDA libraries,\nwhich headers are included by the translation unit, directly or not"),
+  cl::value_desc("include-driven-renames"),
+  cl::cat(ToolTemplateCategory));
+
+cl::opt<std::string> TargetCudaVersion("cuda-version",
+  cl::desc("Target CUDA version X.Y: the CUDA identifiers, introduced after or removed before it, are not hipified;\nthe references to the ones removed in it are reported in the statistics"),
+  cl::value_desc("X.Y"),
+  cl::cat(ToolTemplateCategory));
+
+cl::opt<std::string> TargetHipVersion("hip-version",
+  cl::desc("Target HIP version X.Y[.Z]: the CUDA identifiers, which HIP counterparts are introduced after or removed before it,\nare not hipified; the references to the ones, which HIP counterparts are removed in it, are reported in the statistics"),
+  cl::value_desc("X.Y[.Z]"),
+  cl::cat(ToolTemplateCategory));
+
+cl::opt<std::string> IncludePathRegex("include-path-regex",
+  cl::desc("Hipify only the files of the compilation database (-p), which absolute paths match the regular expression;\nthe database is streamed, and the other entries are skipped without being decoded"),
+  cl::value_desc("regex"),
+  cl::cat(ToolTemplateCategory));
+
+cl::opt<std::string> ExcludePathRegex("exclude-path-regex",
+  cl::desc("Don't hipify the files of the compilation database (-p), which absolute paths match the regular expression"),
+  cl::value_desc("regex"),
+  cl::cat(ToolTemplateCategory));
+
 cl::extrahelp CommonHelp(ct::CommonOptionsParser::HelpMessage);
 
 const std::vector<std::string> hipifyOptions {
   std::string(PrintStatsCSV.ArgStr),
   std::string(PrintStats.ArgStr),
+  std::string(PrintPerfCounters.ArgStr),
   std::string(SkipExcludedPPConditionalBlocks.ArgStr),
   std::string(HipKernelExecutionSyntax.ArgStr),
   std::string(CudaKernelExecutionSyntax.ArgStr),
   std::string(GeneratePerl.ArgStr),
+  std::string(GeneratePerlModulesOption.ArgStr),
   std::string(GeneratePython.ArgStr),
-  std::string(TranslateToRoc.ArgStr),
-  std::string(TranslateToMIOpen.ArgStr),
+  std::string(TranslateToRocOption.ArgStr),
+  std::string(TranslateToMIOpenOption.ArgStr),
   std::string(GenerateMarkdown.ArgStr),
   std::string(GenerateCSV.ArgStr),
   std::string(NoBackup.ArgStr),
   std::string(NoOutput.ArgStr),
   std::string(Inplace.ArgStr),
   std::string(Examine.ArgStr),
-  std::string(SaveTemps.ArgStr),
-  std::string(DocFormat.ArgStr),
+  std::string(SaveTempsOption.ArgStr),
+  std::string(DocFormatOption.ArgStr),
   std::string(Experimental.ArgStr),
+  std::string(Hybrid.ArgStr),
+  std::string(TimeoutLexicalRetry.ArgStr),
+  std::string(IncludeDrivenRenames.ArgStr),
 };
 
 const std::vector<std::string> hipifyOptionsWithTwoArgs {
-  std::string(OutputDir.ArgStr),
-  std::string(OutputHipifyPerlDir.ArgStr),
-  std::string(OutputPythonMapDir.ArgStr),
+  std::string(OutputDirOption.ArgStr),
+  std::string(OutputHipifyPerlDirOption.ArgStr),
+  std::string(OutputPythonMapDirOption.ArgStr),
   std::string(OutputStatsFilename.ArgStr),
+  std::string(StatsFormat.ArgStr),
+  std::string(MetricsFilename.ArgStr),
   std::string(TemporaryDir.ArgStr),
+  std::string(SourceDir.ArgStr),
+  std::string(SourceDirExtensions.ArgStr),
+  std::string(SourceDirIgnore.ArgStr),
+  std::string(FilesFrom.ArgStr),
+  std::string(PerFileTimeout.ArgStr),
+  std::string(MappingOverlay.ArgStr),
+  std::string(MappingDatabase.ArgStr),
+  std::string(TargetCudaVersion.ArgStr),
+  std::string(TargetHipVersion.ArgStr),
+  std::string(IncludePathRegex.ArgStr),
+  std::string(ExcludePathRegex.ArgStr),
 };
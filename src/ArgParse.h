@@ -22,23 +22,20 @@ THE SOFTWARE.
 
 #pragma once
 
-#include "clang/Tooling/CommonOptionsParser.h"
+// The command line options of hipify-clang, which are defined in its executable, not in the hipify library;
+// the ones read by the shared code are bound to the values declared in Options.h.
 #include "llvm/Support/CommandLine.h"
+#include "Options.h"
 
 namespace cl = llvm::cl;
-namespace ct = clang::tooling;
 
 extern cl::OptionCategory ToolTemplateCategory;
 extern cl::opt<std::string> OutputFilename;
-extern cl::opt<std::string> OutputHipifyPerlDir;
-extern cl::opt<std::string> OutputPythonMapDir;
-extern cl::opt<std::string> OutputDir;
 extern cl::opt<std::string> TemporaryDir;
 extern cl::opt<std::string> CudaPath;
 extern cl::list<std::string> IncludeDirs;
 extern cl::list<std::string> MacroNames;
 extern cl::opt<bool> Inplace;
-extern cl::opt<bool> SaveTemps;
 extern cl::opt<bool> GeneratePerl;
 extern cl::opt<bool> GeneratePython;
 extern cl::opt<bool> Verbose;
@@ -47,18 +44,32 @@ extern cl::opt<bool> NoOutput;
 extern cl::opt<bool> PrintStats;
 extern cl::opt<bool> PrintStatsCSV;
 extern cl::opt<std::string> OutputStatsFilename;
+extern cl::opt<std::string> StatsFormat;
+extern cl::opt<bool> PrintPerfCounters;
+extern cl::opt<std::string> MetricsFilename;
 extern cl::opt<bool> Examine;
 extern cl::extrahelp CommonHelp;
-extern cl::opt<bool> TranslateToRoc;
-extern cl::opt<bool> TranslateToMIOpen;
 extern cl::opt<bool> DashDash;
 extern cl::opt<bool> SkipExcludedPPConditionalBlocks;
 extern cl::opt<std::string> CudaGpuArch;
 extern cl::opt<bool> GenerateMarkdown;
 extern cl::opt<bool> GenerateCSV;
-extern cl::opt<std::string> DocFormat;
 extern cl::opt<bool> Experimental;
 extern cl::opt<bool> CudaKernelExecutionSyntax;
 extern cl::opt<bool> HipKernelExecutionSyntax;
+extern cl::opt<bool> Hybrid;
+extern cl::opt<std::string> SourceDir;
+extern cl::list<std::string> SourceDirExtensions;
+extern cl::list<std::string> SourceDirIgnore;
+extern cl::opt<std::string> FilesFrom;
+extern cl::opt<unsigned> PerFileTimeout;
+extern cl::opt<bool> TimeoutLexicalRetry;
+extern cl::opt<std::string> MappingOverlay;
+extern cl::opt<std::string> MappingDatabase;
+extern cl::opt<bool> IncludeDrivenRenames;
+extern cl::opt<std::string> TargetCudaVersion;
+extern cl::opt<std::string> TargetHipVersion;
+extern cl::opt<std::string> IncludePathRegex;
+extern cl::opt<std::string> ExcludePathRegex;
 extern const std::vector<std::string> hipifyOptions;
 extern const std::vector<std::string> hipifyOptionsWithTwoArgs;
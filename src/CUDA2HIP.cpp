@@ -21,6 +21,7 @@ THE SOFTWARE.
 */
 
 #include "CUDA2HIP.h"
+#include <algorithm>
 
 // Maps CUDA header names to HIP header names
 const std::map <llvm::StringRef, hipCounter> CUDA_INCLUDE_MAP {
@@ -86,11 +87,17 @@ const std::map <llvm::StringRef, hipCounter> CUDA_INCLUDE_MAP {
   {"nvrtc.h",                                               {"hiprtc.h",                                              "", CONV_INCLUDE_CUDA_MAIN_H, API_RTC, 0}},
 };
 
+std::map<llvm::StringRef, hipCounter> &CUDA_OVERLAY_MAP() {
+  static std::map<llvm::StringRef, hipCounter> ret;
+  return ret;
+}
+
 const std::map<llvm::StringRef, hipCounter> &CUDA_RENAMES_MAP() {
   static std::map<llvm::StringRef, hipCounter> ret;
   if (!ret.empty())
     return ret;
-  // First run, so compute the union map.
+  // First run, so compute the union map; insert doesn't replace, so the overlay goes first.
+  ret.insert(CUDA_OVERLAY_MAP().begin(), CUDA_OVERLAY_MAP().end());
   ret.insert(CUDA_DRIVER_TYPE_NAME_MAP.begin(), CUDA_DRIVER_TYPE_NAME_MAP.end());
   ret.insert(CUDA_DRIVER_FUNCTION_MAP.begin(), CUDA_DRIVER_FUNCTION_MAP.end());
   ret.insert(CUDA_RUNTIME_TYPE_NAME_MAP.begin(), CUDA_RUNTIME_TYPE_NAME_MAP.end());
@@ -117,6 +124,121 @@ const std::map<llvm::StringRef, hipCounter> &CUDA_RENAMES_MAP() {
   return ret;
 };
 
+namespace {
+  // The part of the union map of the API; the overlay goes first, as there.
+  llvm::StringMap<hipCounter> buildApiRenames(ApiTypes api) {
+    llvm::StringMap<hipCounter> ret;
+    std::vector<const std::map<llvm::StringRef, hipCounter>*> maps{&CUDA_OVERLAY_MAP()};
+    switch (api) {
+      case API_DRIVER: maps.insert(maps.end(), {&CUDA_DRIVER_TYPE_NAME_MAP, &CUDA_DRIVER_FUNCTION_MAP}); break;
+      case API_RUNTIME: maps.insert(maps.end(), {&CUDA_RUNTIME_TYPE_NAME_MAP, &CUDA_RUNTIME_FUNCTION_MAP, &CUDA_DEVICE_TYPE_NAME_MAP}); break;
+      case API_COMPLEX: maps.insert(maps.end(), {&CUDA_COMPLEX_TYPE_NAME_MAP, &CUDA_COMPLEX_FUNCTION_MAP}); break;
+      case API_BLAS: maps.insert(maps.end(), {&CUDA_BLAS_TYPE_NAME_MAP, &CUDA_BLAS_FUNCTION_MAP}); break;
+      case API_RAND: maps.insert(maps.end(), {&CUDA_RAND_TYPE_NAME_MAP, &CUDA_RAND_FUNCTION_MAP}); break;
+      case API_DNN: maps.insert(maps.end(), {&CUDA_DNN_TYPE_NAME_MAP, &CUDA_DNN_FUNCTION_MAP}); break;
+      case API_FFT: maps.insert(maps.end(), {&CUDA_FFT_TYPE_NAME_MAP, &CUDA_FFT_FUNCTION_MAP}); break;
+      case API_SPARSE: maps.insert(maps.end(), {&CUDA_SPARSE_TYPE_NAME_MAP, &CUDA_SPARSE_FUNCTION_MAP}); break;
+      case API_CUB: maps.insert(maps.end(), {&CUDA_CUB_TYPE_NAME_MAP, &CUDA_CUB_FUNCTION_MAP}); break;
+      case API_CAFFE2: maps.insert(maps.end(), {&CUDA_CAFFE2_TYPE_NAME_MAP, &CUDA_CAFFE2_FUNCTION_MAP}); break;
+      case API_RTC: maps.insert(maps.end(), {&CUDA_RTC_TYPE_NAME_MAP, &CUDA_RTC_FUNCTION_MAP}); break;
+      default: break;
+    }
+    for (const auto map : maps) {
+      for (const auto &m : *map) {
+        if (m.second.apiType == api) ret.insert({m.first, m.second});
+      }
+    }
+    return ret;
+  }
+
+  std::vector<llvm::StringMap<hipCounter>> buildAllApiRenames() {
+    std::vector<llvm::StringMap<hipCounter>> ret;
+    ret.reserve(NUM_API_TYPES);
+    for (int api = 0; api < NUM_API_TYPES; ++api)
+      ret.push_back(buildApiRenames(ApiTypes(api)));
+    return ret;
+  }
+}
+
+const llvm::StringMap<hipCounter> &CUDA_API_RENAMES_MAP(ApiTypes api) {
+  // Built at the first call only, which is thread-safe, as the concurrent hipifications might make it.
+  static const std::vector<llvm::StringMap<hipCounter>> ret = buildAllApiRenames();
+  return ret[api];
+}
+
+namespace {
+  bool bTargetVersions = false;
+  llvm::StringMap<hipCounter> targetRenames;
+}
+
+void setTargetVersions(cudaVersions cudaVersion, hipVersions hipVersion) {
+  targetRenames.clear();
+  bTargetVersions = cudaVersion != CUDA_0 || hipVersion != HIP_0;
+  if (!bTargetVersions)
+    return;
+  for (const auto &m : CUDA_RENAMES_MAP()) {
+    const hipRecord *record = findRecord(m.first);
+    bool bRemovedInTarget = false;
+    // The versions of the DNN API are cuDNN ones; a name without a record has no versions to check.
+    if (record && cudaVersion != CUDA_0 && m.second.apiType != API_DNN) {
+      const cudaAPIversions &ver = record->cudaVer;
+      if (ver.appeared > cudaVersion || (ver.removed != CUDA_0 && ver.removed < cudaVersion))
+        continue;
+      bRemovedInTarget = ver.removed == cudaVersion;
+    }
+    if (record && hipVersion != HIP_0 && !m.second.hipName.empty()) {
+      const hipAPIversions &ver = record->hipVer;
+      if (ver.appeared > hipVersion || (ver.removed != HIP_0 && ver.removed < hipVersion))
+        continue;
+      bRemovedInTarget = bRemovedInTarget || ver.removed == hipVersion;
+    }
+    hipCounter counter = m.second;
+    if (bRemovedInTarget)
+      counter.supportDegree |= REMOVED_IN_TARGET;
+    targetRenames.insert({m.first, counter});
+  }
+}
+
+const llvm::StringMap<hipCounter> *CUDA_TARGET_RENAMES_MAP() {
+  return bTargetVersions ? &targetRenames : nullptr;
+}
+
+namespace {
+  std::vector<hipRecord> buildRecords() {
+    std::vector<hipRecord> ret;
+    const auto &renames = CUDA_RENAMES_MAP();
+    ret.reserve(renames.size() + CUDA_DEVICE_FUNCTION_MAP.size());
+    for (const auto &m : renames)
+      ret.push_back({m.first, m.second, {CUDA_0, CUDA_0, CUDA_0}, {HIP_0, HIP_0, HIP_0}});
+    for (const auto &m : CUDA_DEVICE_FUNCTION_MAP)
+      if (renames.find(m.first) == renames.end())
+        ret.push_back({m.first, m.second, {CUDA_0, CUDA_0, CUDA_0}, {HIP_0, HIP_0, HIP_0}});
+    std::sort(ret.begin(), ret.end(), [](const hipRecord &l, const hipRecord &r) { return l.cudaName < r.cudaName; });
+    const auto &cudaVersionsMap = CUDA_VERSIONS_MAP();
+    const auto &hipVersionsMap = HIP_VERSIONS_MAP();
+    for (auto &record : ret) {
+      const auto cv = cudaVersionsMap.find(record.cudaName);
+      if (cv != cudaVersionsMap.end()) record.cudaVer = cv->second;
+      const auto hv = hipVersionsMap.find(record.counter.hipName);
+      if (hv != hipVersionsMap.end()) record.hipVer = hv->second;
+    }
+    return ret;
+  }
+}
+
+const std::vector<hipRecord> &CUDA_RECORDS() {
+  static const std::vector<hipRecord> ret = buildRecords();
+  return ret;
+}
+
+const hipRecord *findRecord(llvm::StringRef cudaName) {
+  const auto &records = CUDA_RECORDS();
+  const auto found = std::lower_bound(records.begin(), records.end(), cudaName,
+    [](const hipRecord &record, llvm::StringRef name) { return record.cudaName < name; });
+  if (found == records.end() || found->cudaName != cudaName) return nullptr;
+  return &*found;
+}
+
 const std::map<llvm::StringRef, cudaAPIversions> &CUDA_VERSIONS_MAP() {
   static std::map<llvm::StringRef, cudaAPIversions> ret;
   if (!ret.empty())
@@ -22,9 +22,11 @@ THE SOFTWARE.
 
 #pragma once
 
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include <set>
 #include <map>
+#include <vector>
 #include "Statistics.h"
 
 const std::string sHIP_version = Statistics::getHipVersion(HIP_LATEST);
@@ -82,8 +84,11 @@ extern const std::map<llvm::StringRef, hipCounter> CUDA_RTC_TYPE_NAME_MAP;
 // Maps the names of CUDA RTC API functions to the corresponding HIP functions
 extern const std::map<llvm::StringRef, hipCounter> CUDA_RTC_FUNCTION_MAP;
 
+// Maps the names of the user's CUDA identifiers, loaded by --mapping-overlay, to the corresponding HIP identifiers
+std::map<llvm::StringRef, hipCounter> &CUDA_OVERLAY_MAP();
+
 /**
-  * The union of all the above maps, except includes.
+  * The union of all the above maps, except includes; the overlay's entries take precedence over the built-in ones.
   *
   * This should be used rarely, but is still needed to convert macro definitions (which can
   * contain any combination of the above things). AST walkers can usually get away with just
@@ -92,6 +97,23 @@ extern const std::map<llvm::StringRef, hipCounter> CUDA_RTC_FUNCTION_MAP;
   */
 const std::map<llvm::StringRef, hipCounter> &CUDA_RENAMES_MAP();
 
+/**
+  * The part of CUDA_RENAMES_MAP() of a single API, hashed; is computed at the first use for the API,
+  * so the tables of the APIs, which are never looked up, aren't touched.
+  */
+const llvm::StringMap<hipCounter> &CUDA_API_RENAMES_MAP(ApiTypes api);
+
+/**
+  * Sets the target CUDA and HIP versions of --cuda-version and --hip-version (CUDA_0, HIP_0 - not set) and prunes
+  * CUDA_RENAMES_MAP() to the renames, which are available in both of them: the ones introduced after, or removed
+  * before, the target versions are dropped; the ones removed in the target releases are marked REMOVED_IN_TARGET.
+  * The versions of the CUDA identifiers are checked by CUDA_VERSIONS_MAP(), of the HIP ones - by HIP_VERSIONS_MAP().
+  */
+void setTargetVersions(cudaVersions cudaVersion, hipVersions hipVersion);
+
+// The renames pruned by setTargetVersions, hashed, or nullptr if no target version is set
+const llvm::StringMap<hipCounter> *CUDA_TARGET_RENAMES_MAP();
+
 extern const std::map<llvm::StringRef, cudaAPIversions> CUDA_DRIVER_TYPE_NAME_VER_MAP;
 extern const std::map<llvm::StringRef, cudaAPIversions> CUDA_DRIVER_FUNCTION_VER_MAP;
 extern const std::map<llvm::StringRef, cudaAPIversions> CUDA_RUNTIME_TYPE_NAME_VER_MAP;
@@ -154,6 +176,27 @@ extern const std::map<llvm::StringRef, hipAPIversions> HIP_RTC_FUNCTION_VER_MAP;
   */
 const std::map<llvm::StringRef, hipAPIversions>& HIP_VERSIONS_MAP();
 
+/**
+  * A CUDA identifier with its rename, the versions of the CUDA identifier and the versions of the HIP one, which are
+  * otherwise looked up in CUDA_VERSIONS_MAP() by the CUDA name and in HIP_VERSIONS_MAP() by the HIP name; the unknown
+  * versions are CUDA_0 and HIP_0.
+  */
+struct hipRecord {
+  llvm::StringRef cudaName;
+  hipCounter counter;
+  cudaAPIversions cudaVer;
+  hipAPIversions hipVer;
+};
+
+/**
+  * The records of all the identifiers of CUDA_RENAMES_MAP() and CUDA_DEVICE_FUNCTION_MAP, sorted by the CUDA name
+  * and stored contiguously; is computed once at the first use, which is thread-safe.
+  */
+const std::vector<hipRecord> &CUDA_RECORDS();
+
+// The record of the CUDA identifier found by a single binary search over CUDA_RECORDS(), or nullptr
+const hipRecord *findRecord(llvm::StringRef cudaName);
+
 extern const std::map<unsigned int, llvm::StringRef> CUDA_DRIVER_API_SECTION_MAP;
 extern const std::map<unsigned int, llvm::StringRef> CUDA_RUNTIME_API_SECTION_MAP;
 extern const std::map<unsigned int, llvm::StringRef> CUDA_COMPLEX_API_SECTION_MAP;
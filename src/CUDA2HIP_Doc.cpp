@@ -20,14 +20,17 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 
+#include <fstream>
 #include <sstream>
+#include <thread>
 #include <vector>
 #include <map>
+#include "llvm/Support/MemoryBuffer.h"
 #include "CUDA2HIP.h"
 #include "CUDA2HIP_Scripting.h"
-#include "ArgParse.h"
+#include "Options.h"
 #include "StringUtils.h"
-#include "LLVMCompat.h"
+#include "LLVMCompatSupport.h"
 
 namespace doc {
 
@@ -129,96 +132,43 @@ namespace doc {
         types = docTypes;
         format = docFormat;
       }
-      bool generate() {
-        if (init()) return write() & fini();
-        return false;
-      }
-      virtual void setCommonHipVersionMap() {}
-
-    protected:
-      virtual const string &getFileName(docType t) const = 0;
-      virtual const string &getName() const = 0;
-      virtual const sectionMap &getSections() const = 0;
-      virtual const functionMap &getFunctions() const = 0;
-      virtual const typeMap &getTypes() const = 0;
-      virtual const versionMap &getFunctionVersions() const = 0;
-      virtual const hipVersionMap &getHipFunctionVersions() const = 0;
-      virtual const versionMap &getTypeVersions() const = 0;
-      virtual const hipVersionMap &getHipTypeVersions() const = 0;
-      hipVersionMap commonHipVersionMap;
-
-    private:
-      string dir;
-      error_code EC;
-      unsigned int types;
-      unsigned int format;
-      map<docType, string> files;
-      map<docType, string> tmpFiles;
-      map<docType, unique_ptr<ostream>> streams;
-
-      bool init(docType t) {
-        string file = (dir.empty() ? getFileName(t) : dir + "/" + getFileName(t));
-        SmallString<128> tmpFile;
-        EC = sys::fs::createTemporaryFile(file, getExtension(t), tmpFile);
-        if (EC) {
-          errs() << "\n" << sHipify << sError << EC.message() << ": " << tmpFile << "\n";
-          return false;
-        }
-        files.insert({ t, file });
-        tmpFiles.insert({ t, tmpFile.str().str() });
-        streams.insert(make_pair(t, unique_ptr<ostream>(new ofstream(tmpFile.c_str(), ios_base::trunc))));
-        return true;
-      }
-
-      bool init() {
-        bool bRet = true;
-        if (md == (types & md)) bRet = init(md);
-        if (csv == (types & csv)) bRet = init(csv) & bRet;
-        return bRet;
-      }
-
-      bool isTypeSection(unsigned int n, const sectionMap &sections) {
-        string name = string(sections.at(n));
-        for (auto &c : name) c = tolower(c);
-        return name.find("type") != string::npos;
-      }
-
-      bool write() {
+      // Render the documents in memory; the documents share only the constant maps and records, so they might be rendered concurrently.
+      void render() {
+        // Group the entries by section in a single pass over the functions and types.
+        const sectionMap &sections = getSections();
+        map<unsigned int, bool> typeSections;
+        for (auto &s : sections) typeSections[s.first] = isTypeSection(s.first, sections);
+        map<unsigned int, vector<const functionMap::value_type*>> sectionEntries;
+        auto group = [&](const functionMap &ftMap, bool bTypes) {
+          for (auto &f : ftMap) {
+            auto ts = typeSections.find(f.second.apiSection);
+            if (ts == typeSections.end() || ts->second != bTypes) continue;
+            if (format == full || !Statistics::isUnsupported(f.second)) sectionEntries[ts->first].push_back(&f);
+          }
+        };
+        group(getFunctions(), false);
+        group(getTypes(), true);
         const docType docs[] = {md, csv};
         for (auto doc : docs) {
           if (doc != (types & doc)) continue;
-          *streams[doc].get() << (doc == md ? "# " : "") << getName() << " " << sAPI_supported << endl << endl;
+          streams[doc] << (doc == md ? "# " : "") << getName() << " " << sAPI_supported << endl << endl;
           unsigned int compact_only_cur_sec_num = 1;
-          for (auto &s : getSections()) {
-            const functionMap &ftMap = isTypeSection(s.first, getSections()) ? getTypes() : getFunctions();
-            const versionMap &vMap = isTypeSection(s.first, getSections()) ? getTypeVersions() : getFunctionVersions();
-            const hipVersionMap &hMap = commonHipVersionMap.empty() ? (isTypeSection(s.first, getSections()) ? getHipTypeVersions() : getHipFunctionVersions()) : commonHipVersionMap;
-            functionMap fMap;
-            for (auto &f : ftMap) {
-              if (f.second.apiSection == s.first) {
-                if (format == full || (format != full && !Statistics::isUnsupported(f.second))) {
-                  fMap.insert(f);
-                }
-              }
-            }
+          for (auto &s : sections) {
+            const vector<const functionMap::value_type*> &fMap = sectionEntries[s.first];
             string sS = (doc == md) ? "|" : ",";
             stringstream rows;
-            for (auto &f : fMap) {
+            for (auto fp : fMap) {
+              auto &f = *fp;
               string a, d, r, ha, hd, hr, he;
-              for (auto &v : vMap) {
-                if (v.first == f.first) {
-                  a = Statistics::getCudaVersion(v.second.appeared);
-                  d = Statistics::getCudaVersion(v.second.deprecated);
-                  r = Statistics::getCudaVersion(v.second.removed);
-                  break;
-                }
-              }
-              auto hv = hMap.find(f.second.hipName);
-              if (hv != hMap.end() && !Statistics::isUnsupported(f.second)) {
-                ha = Statistics::getHipVersion(hv->second.appeared);
-                hd = Statistics::getHipVersion(hv->second.deprecated);
-                hr = Statistics::getHipVersion(hv->second.removed);
-                he = Statistics::getHipVersion(hv->second.experimental);
+              hipRecord record = getRecord(f, typeSections[s.first]);
+              a = Statistics::getCudaVersion(record.cudaVer.appeared);
+              d = Statistics::getCudaVersion(record.cudaVer.deprecated);
+              r = Statistics::getCudaVersion(record.cudaVer.removed);
+              if (!Statistics::isUnsupported(f.second)) {
+                ha = Statistics::getHipVersion(record.hipVer.appeared);
+                hd = Statistics::getHipVersion(record.hipVer.deprecated);
+                hr = Statistics::getHipVersion(record.hipVer.removed);
+                he = Statistics::getHipVersion(record.hipVer.experimental);
               }
               string sHip = Statistics::isUnsupported(f.second) ? "" : string(f.second.hipName);
               if (doc == md) {
@@ -268,41 +218,98 @@ namespace doc {
               case full:
               case strict:
               default:
-                *streams[doc].get() << section_header.str();
-                *streams[doc].get() << (fMap.empty() ? "Unsupported\n\n" : section.str());
+                streams[doc] << section_header.str();
+                streams[doc] << (fMap.empty() ? "Unsupported\n\n" : section.str());
                 break;
               case compact:
                 if (!rows.str().empty()) {
-                  *streams[doc].get() << section_header.str() << section.str();
+                  streams[doc] << section_header.str() << section.str();
                   compact_only_cur_sec_num++;
                 }
                 break;
             }
             if (!rows.str().empty()) {
-              *streams[doc].get() << rows.str() << endl;
+              streams[doc] << rows.str() << endl;
             }
           }
-          *streams[doc].get() << endl << (doc == md ? "\\" : "") << (format == full ? "*A - Added; D - Deprecated; R - Removed; E - Experimental" : "*D - Deprecated; E - Experimental");
+          streams[doc] << endl << (doc == md ? "\\" : "") << (format == full ? "*A - Added; D - Deprecated; R - Removed; E - Experimental" : "*D - Deprecated; E - Experimental");
         }
-        return true;
       }
 
-      bool fini(docType format) {
-        streams[format].get()->flush();
+      // Write the rendered documents, skipping the files, which content is unchanged.
+      bool write() {
         bool bRet = true;
-        EC = sys::fs::copy_file(tmpFiles[format], files[format]);
-        if (EC) {
-          errs() << "\n" << sHipify << sError << EC.message() << ": while copying " << tmpFiles[format] << " to " << files[format] << "\n";
-          bRet = false;
-        }
-        if (!SaveTemps) sys::fs::remove(tmpFiles[format]);
+        if (md == (types & md)) bRet = write(md);
+        if (csv == (types & csv)) bRet = write(csv) & bRet;
         return bRet;
       }
+      virtual void setCommonHipVersionMap() {}
+
+    private:
+      /**
+        * The record of the identifier of the API: found by a single lookup, unless the identifier is also in another API
+        * with other versions or is renamed by the overlay, then its versions are looked up in the maps of the API.
+        */
+      hipRecord getRecord(const functionMap::value_type &f, bool bTypes) const {
+        const hipRecord *found = findRecord(f.first);
+        if (found && found->counter.apiType == f.second.apiType && found->counter.hipName == f.second.hipName) return *found;
+        hipRecord record{f.first, f.second, {CUDA_0, CUDA_0, CUDA_0}, {HIP_0, HIP_0, HIP_0}};
+        const versionMap &vMap = bTypes ? getTypeVersions() : getFunctionVersions();
+        const auto v = vMap.find(f.first);
+        if (v != vMap.end()) record.cudaVer = v->second;
+        const hipVersionMap &hMap = commonHipVersionMap.empty() ? (bTypes ? getHipTypeVersions() : getHipFunctionVersions()) : commonHipVersionMap;
+        const auto hv = hMap.find(f.second.hipName);
+        if (hv != hMap.end()) record.hipVer = hv->second;
+        return record;
+      }
 
-      bool fini() {
+    protected:
+      virtual const string &getFileName(docType t) const = 0;
+      virtual const string &getName() const = 0;
+      virtual const sectionMap &getSections() const = 0;
+      virtual const functionMap &getFunctions() const = 0;
+      virtual const typeMap &getTypes() const = 0;
+      virtual const versionMap &getFunctionVersions() const = 0;
+      virtual const hipVersionMap &getHipFunctionVersions() const = 0;
+      virtual const versionMap &getTypeVersions() const = 0;
+      virtual const hipVersionMap &getHipTypeVersions() const = 0;
+      hipVersionMap commonHipVersionMap;
+
+    private:
+      string dir;
+      unsigned int types;
+      unsigned int format;
+      map<docType, stringstream> streams;
+
+      bool isTypeSection(unsigned int n, const sectionMap &sections) {
+        string name = string(sections.at(n));
+        for (auto &c : name) c = tolower(c);
+        return name.find("type") != string::npos;
+      }
+
+      bool write(docType t) {
+        string file = (dir.empty() ? getFileName(t) : dir + "/" + getFileName(t));
+        string content = streams[t].str();
+        // Skip rewriting the unchanged document, so that its timestamp isn't updated either.
+        auto buffer = MemoryBuffer::getFile(file);
+        if (buffer && (*buffer)->getBuffer() == content) return true;
+        SmallString<128> tmpFile;
+        error_code EC = sys::fs::createTemporaryFile(file, getExtension(t), tmpFile);
+        if (EC) {
+          errs() << "\n" << sHipify << sError << EC.message() << ": " << tmpFile << "\n";
+          return false;
+        }
+        {
+          ofstream tmpStream(tmpFile.c_str(), ios_base::trunc);
+          tmpStream << content;
+        }
         bool bRet = true;
-        if (md == (types & md)) bRet = fini(md);
-        if (csv == (types & csv)) bRet = fini(csv) & bRet;
+        EC = sys::fs::copy_file(tmpFile, file);
+        if (EC) {
+          errs() << "\n" << sHipify << sError << EC.message() << ": while copying " << tmpFile << " to " << file << "\n";
+          bRet = false;
+        }
+        if (!SaveTemps) sys::fs::remove(tmpFile);
         return bRet;
       }
 
@@ -326,11 +333,16 @@ namespace doc {
       virtual ~DOCS() {}
       void addDoc(DOC *doc) { docs.push_back(doc); doc->setTypesAndFormat(types, format); }
       bool generate() {
-        bool bRet = true;
+        vector<thread> threads;
         for (auto &d : docs) {
-          d->setCommonHipVersionMap();
-          bRet = d->generate() & bRet;
+          threads.emplace_back([d]() {
+            d->setCommonHipVersionMap();
+            d->render();
+          });
         }
+        for (auto &t : threads) t.join();
+        bool bRet = true;
+        for (auto &d : docs) bRet = d->write() & bRet;
         return bRet;
       }
   };
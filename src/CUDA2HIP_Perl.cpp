@@ -27,9 +27,9 @@ THE SOFTWARE.
 #include "llvm/Support/Path.h"
 #include "CUDA2HIP.h"
 #include "CUDA2HIP_Scripting.h"
-#include "ArgParse.h"
+#include "Options.h"
 #include "StringUtils.h"
-#include "LLVMCompat.h"
+#include "LLVMCompatSupport.h"
 #include "Statistics.h"
 
 namespace perl {
@@ -104,67 +104,88 @@ namespace perl {
   const string sRocSubstitutions = "rocSubstitutions";
   const string sSubst = "subst";
   const string sExperimentalSubstitutions = "experimentalSubstitutions";
+  const string sNameSubstitutions = "nameSubstitutions";
+  const string sSubstName = "substName";
+  const string sSimpleNames = "simple_names";
+  const string sExperimentalNames = "experimental_names";
+  const string sRocNames = "roc_names";
   const string sTransformKernelLaunch = "transformKernelLaunch";
   const string sTransformCubNamespace = "transformCubNamespace";
   const string sCountSupportedDeviceFunctions = "countSupportedDeviceFunctions";
+  const string sHipifyFile = "hipifyFile";
+  const string sHipifyFilesInParallel = "hipifyFilesInParallel";
 
-  const string sCudaDevice = "cudaDevice";
-  const string sCudaDeviceId = "cudaDeviceId";
-  const string sCudaDevices = "cudaDevices";
-  const string sCudaDevice_t = "cudaDevice_t";
-  const string sCudaIDs = "cudaIDs";
-  const string sCudaGridDim = "cudaGridDim";
-  const string sCudaDimGrid = "cudaDimGrid";
-  const string sCudaDimBlock = "cudaDimBlock";
-  const string sCudaGradInput = "cudaGradInput";
-  const string sCudaGradOutput = "cudaGradOutput";
-  const string sCudaInput = "cudaInput";
-  const string sCudaOutput = "cudaOutput";
-  const string sCudaOprod = "cudaOprod";
-  const string sCudaOprod_ex = "cudaOprod_ex";
-  const string sCudaLongLinkOprod = "cudaLongLinkOprod";
-  const string sCudaLongLinkOprod_ex = "cudaLongLinkOprod_ex";
-  const string sCudaQuark = "cudaQuark";
-  const string sCudaIndices = "cudaIndices";
-  const string sCudaGaugeField = "cudaGaugeField";
-  const string sCudaQdpGauge = "cudaQdpGauge";
-  const string sCudaCpsGauge = "cudaCpsGauge";
-  const string sCudaMom = "cudaMom";
-  const string sCudaGauge = "cudaGauge";
-  const string sCudaGauge_ex = "cudaGauge_ex";
-  const string sCudaInGauge = "cudaInGauge";
-  const string sCudaInGaugeEx = "cudaInGaugeEx";
-  const string sCudaOutGauge = "cudaOutGauge";
-  const string sCudaGaugeTemp = "cudaGaugeTemp";
-  const string sCudaSpinorOut = "cudaSpinorOut";
-  const string sCudaSpinor = "cudaSpinor";
-  const string sCudaColorSpinorField = "cudaColorSpinorField";
-  const string sCudaInLink = "cudaInLink";
-  const string sCudaInLinkEx = "cudaInLinkEx";
-  const string sCudaSiteLink = "cudaSiteLink";
-  const string sCudaFatLink = "cudaFatLink";
-  const string sCudaLongLink = "cudaLongLink";
-  const string sCudaUnitarizedLink = "cudaUnitarizedLink";
-  const string sCudaULink = "cudaULink";
-  const string sCudaStaple = "cudaStaple";
-  const string sCudaCloverField = "cudaCloverField";
-  const string sCudaParam = "cudaParam";
-  const string sCudaForce = "cudaForce";
-  const string sCudaInForce = "cudaInForce";
-  const string sCudaForce_ex = "cudaForce_ex";
-  const string sCudaOutForce = "cudaOutForce";
-  const string sCudaResult = "cudaResult";
-  const string sCudaMemcpys ="cudaMemcpys";
-  const string sCudaRitzVectors = "cudaRitzVectors";
-  const string sCudaEigValueSet = "cudaEigValueSet";
-  const string sCudaEigVecSet = "cudaEigVecSet";
-  
-  const set<string> Whitelist{
-    {sCudaDevice}, {sCudaDevice_t}, {sCudaIDs}, {sCudaGridDim}, {sCudaDimGrid}, {sCudaDimBlock}, {sCudaDeviceId}, {sCudaDevices},
-    {sCudaGradInput}, {sCudaGradOutput}, {sCudaInput}, {sCudaOutput}, {sCudaIndices}, {sCudaMom}, {sCudaGauge},
-    {sCudaInGauge}, {sCudaSpinorOut}, {sCudaSpinor}, {sCudaColorSpinorField}, {sCudaSiteLink}, {sCudaFatLink}, {sCudaStaple}, {sCudaCloverField}, {sCudaParam}, {sCudaOutForce}, {sCudaGaugeTemp}, {sCudaResult}, {sCudaForce}, {sCudaInForce}, {sCudaForce_ex}, {sCudaOprod_ex}, {sCudaOutGauge}, {sCudaULink}, {sCudaOprod}, {sCudaGauge_ex}, {sCudaQuark}, {sCudaLongLinkOprod_ex}, {sCudaInGaugeEx}, {sCudaLongLink}, {sCudaUnitarizedLink}, {sCudaQdpGauge}, {sCudaCpsGauge}, {sCudaInLink}, {sCudaInLinkEx}, {sCudaGaugeField}, {sCudaMemcpys}, {sCudaRitzVectors}, {sCudaEigValueSet}, {sCudaLongLinkOprod}, {sCudaEigVecSet}
+  // A regex, matching any of the names; the lines without a match are not scanned by the per-name loops.
+  string getNamesRegex(const vector<string> &names) {
+    string sRegex = buildTrieRegex(names);
+    return sRegex.empty() ? "(?!)" : sRegex;
+  }
+
+  vector<string> getNames(const VersionedNames &names) {
+    vector<string> v;
+    for (auto &n : names) v.push_back(n.first);
+    return v;
+  }
+
+  const string sModulesDir = "hipify-perl-modules";
+  const char *moduleNames[NUM_API_TYPES] = { "driver", "runtime", "complex", "blas", "rand", "dnn", "fft", "sparse", "cub", "caffe2", "rtc" };
+  // The minimal number of the first characters of the names, by which the driver decides whether to load a module
+  const size_t modulePrefixSize = 4;
+
+  // A module of the modular hipify-perl (--perl-modules) with the names and the warning lists of a single API.
+  struct Module {
+    ApiTypes api;
+    // All the CUDA identifiers of the module
+    set<string> names;
+    // The entries of the module's hashes and lists by the variable names
+    map<string, vector<string>> entries;
+    // The names to warn about by the variable names of the warning lists
+    map<string, vector<string>> warnNames;
   };
 
+  typedef map<string, Module> Modules;
+
+  Module &getModule(Modules &modules, const string &cudaName) {
+    const auto found = CUDA_RENAMES_MAP().find(cudaName);
+    ApiTypes api = found != CUDA_RENAMES_MAP().end() ? found->second.apiType : API_RUNTIME;
+    Module &module = modules[moduleNames[api]];
+    module.api = api;
+    module.names.insert(cudaName);
+    return module;
+  }
+
+  // The prefixes of the module's names, which are long enough not to be the prefixes of the other modules' names where possible,
+  // so that a source without any of them doesn't need the module, and the module isn't loaded for the names of the other modules.
+  vector<string> getModulePrefixes(const Modules &modules, const string &sModule) {
+    vector<pair<string, string>> all;
+    for (auto &m : modules)
+      for (auto &n : m.second.names) all.push_back({n, m.first});
+    std::sort(all.begin(), all.end());
+    auto commonPrefixSize = [](const string &a, const string &b) {
+      size_t i = 0;
+      while (i < a.size() && i < b.size() && a[i] == b[i]) ++i;
+      return i;
+    };
+    set<string> prefixes;
+    for (size_t i = 0; i < all.size(); ++i) {
+      if (all[i].second != sModule) continue;
+      // In the sorted names, the longest common prefix with the other modules' names is the one with the nearest of them
+      size_t size = modulePrefixSize;
+      for (size_t j = i; j-- > 0;) {
+        if (all[j].second == sModule) continue;
+        size = max(size, commonPrefixSize(all[i].first, all[j].first) + 1);
+        break;
+      }
+      for (size_t j = i + 1; j < all.size(); ++j) {
+        if (all[j].second == sModule) continue;
+        size = max(size, commonPrefixSize(all[i].first, all[j].first) + 1);
+        break;
+      }
+      prefixes.insert(all[i].first.substr(0, size));
+    }
+    return vector<string>(prefixes.begin(), prefixes.end());
+  }
+
   void generateHeader(unique_ptr<ostream> &streamPtr) {
     *streamPtr.get() << "#!/usr/bin/env perl" << endl_2;
     *streamPtr.get() << sCopyright << endl;
@@ -183,6 +204,7 @@ namespace perl {
     *streamPtr.get() << "      -help                         - Display available options" << endl;
     *streamPtr.get() << "      -hip-kernel-execution-syntax  - Transform CUDA kernel launch syntax to a regular HIP function call (overrides \"--cuda-kernel-execution-syntax\")" << endl;
     *streamPtr.get() << "      -inplace                      - Backup the input file in .prehip file, modify the input file inplace" << endl;
+    *streamPtr.get() << "      -j=i                          - Number of parallel jobs (only with -inplace or -no-output)" << endl;
     *streamPtr.get() << "      -no-output                    - Don't write any translated output to stdout" << endl;
     *streamPtr.get() << "      -o=s                          - Output filename" << endl;
     *streamPtr.get() << "      -print-stats                  - Print translation statistics" << endl;
@@ -196,11 +218,14 @@ namespace perl {
     *streamPtr.get() << "use Cwd;" << endl;
     *streamPtr.get() << "use Getopt::Long;" << endl;
     *streamPtr.get() << "use File::Basename;" << endl;
+    *streamPtr.get() << "use IO::Handle;" << endl;
+    *streamPtr.get() << "use IO::Select;" << endl;
     *streamPtr.get() << my << "$whitelist = \"\";" << endl;
     *streamPtr.get() << my << "$exclude_dirs =  \"\";" << endl;
     *streamPtr.get() << my << "$exclude_files = \"\";" << endl;
     *streamPtr.get() << my << "$fileName = \"\";" << endl;
     *streamPtr.get() << my << "$hipFileName = \"\";" << endl;
+    *streamPtr.get() << my << "$jobs = 1;" << endl;
     *streamPtr.get() << my << "%ft;" << endl;
     *streamPtr.get() << my << "%Tkernels;" << endl;
     *streamPtr.get() << my << "%tags = ();" << endl;
@@ -218,6 +243,7 @@ namespace perl {
     *streamPtr.get() << tab << ", \"help\" => \\$help                                                  # Display available options" << endl;
     *streamPtr.get() << tab << ", \"hip-kernel-execution-syntax\" => \\$hip_kernel_execution_syntax    # Transform CUDA kernel launch syntax to a regular HIP function call (overrides \"--cuda-kernel-execution-syntax\")" << endl;
     *streamPtr.get() << tab << ", \"inplace\" => \\$inplace                                            # Backup the input file in .prehip file, modify the input file inplace" << endl;
+    *streamPtr.get() << tab << ", \"j=i\" => \\$jobs                                                   # Number of parallel jobs (only with -inplace or -no-output)" << endl;
     *streamPtr.get() << tab << ", \"no-output\" => \\$no_output                                        # Don't write any translated output to stdout" << endl;
     *streamPtr.get() << tab << ", \"o=s\" => \\$hipFileName                                            # Output filename" << endl;
     *streamPtr.get() << tab << ", \"print-stats\" => \\$print_stats                                    # Print translation statistics" << endl;
@@ -227,44 +253,32 @@ namespace perl {
     *streamPtr.get() << tab << ", \"whitelist=s\" => \\$whitelist                                      # Whitelist of identifiers" << endl;
     *streamPtr.get() << ");" << endl_2;
     *streamPtr.get() << "$cuda_kernel_execution_syntax = 1;" << endl_2;
-    stringstream deprecated, removed, experimental, common;
-    deprecated << my << "%deprecated_funcs = (" << endl;
-    removed << my << "%removed_funcs = (" << endl;
-    experimental << my << "%experimental_funcs = (" << endl;
-    unsigned int countDeprecated = 0, countRemoved = 0, countExperimental = 0;
-    for (auto ma = CUDA_RENAMES_MAP().rbegin(); ma != CUDA_RENAMES_MAP().rend(); ++ma) {
-      bool bDeprecated = false, bRemoved = false, bExperimental = false;
-      if (Statistics::isCudaDeprecated(ma->second)) bDeprecated = true;
-      if (Statistics::isCudaRemoved(ma->second)) bRemoved = true;
-      if (Statistics::isHipExperimental(ma->second)) bExperimental = true;
-      if (bDeprecated || bRemoved) {
-        const auto found = CUDA_VERSIONS_MAP().find(ma->first);
-        if (found != CUDA_VERSIONS_MAP().end()) {
-          if (bDeprecated) {
-            deprecated << (countDeprecated ? ",\n" : "") << tab << "\"" << ma->first.str() << "\" => \"" << Statistics::getCudaVersion(found->second.deprecated) << "\"";
-            countDeprecated++;
-          }
-          if (bRemoved) {
-            removed << (countRemoved ? ",\n" : "") << tab << "\"" << ma->first.str() << "\" => \"" << Statistics::getCudaVersion(found->second.removed) << "\"";
-            countRemoved++;
-          }
-        }
-      }
-      if (bExperimental) {
-        const auto found = HIP_VERSIONS_MAP().find(ma->second.hipName);
-        if (found != HIP_VERSIONS_MAP().end()) {
-          experimental << (countExperimental ? ",\n" : "") << tab << "\"" << ma->first.str() << "\" => \"" << Statistics::getHipVersion(found->second.experimental) << "\"";
-          countExperimental++;
-        }
-      }
+    if (GeneratePerlModules) {
+      *streamPtr.get() << "# Filled in by the modules" << endl;
+      *streamPtr.get() << my << "%deprecated_funcs;" << endl;
+      *streamPtr.get() << my << "%removed_funcs;" << endl;
+      *streamPtr.get() << my << "%experimental_funcs;" << endl_2;
+    } else {
+      stringstream deprecated, removed, experimental, common;
+      deprecated << my << "%deprecated_funcs = (" << endl;
+      removed << my << "%removed_funcs = (" << endl;
+      experimental << my << "%experimental_funcs = (" << endl;
+      VersionedNames deprecatedNames, removedNames, experimentalNames;
+      getVersionedNames(deprecatedNames, removedNames, experimentalNames);
+      for (auto &n : deprecatedNames)
+        deprecated << (&n != &deprecatedNames.front() ? ",\n" : "") << tab << "\"" << n.first << "\" => \"" << n.second << "\"";
+      for (auto &n : removedNames)
+        removed << (&n != &removedNames.front() ? ",\n" : "") << tab << "\"" << n.first << "\" => \"" << n.second << "\"";
+      for (auto &n : experimentalNames)
+        experimental << (&n != &experimentalNames.front() ? ",\n" : "") << tab << "\"" << n.first << "\" => \"" << n.second << "\"";
+      common << endl << ");" << endl << endl;
+      deprecated << common.str();
+      removed << common.str();
+      experimental << common.str();
+      *streamPtr.get() << deprecated.str();
+      *streamPtr.get() << removed.str();
+      *streamPtr.get() << experimental.str();
     }
-    common << endl << ");" << endl << endl;
-    deprecated << common.str();
-    removed << common.str();
-    experimental << common.str();
-    *streamPtr.get() << deprecated.str();
-    *streamPtr.get() << removed.str();
-    *streamPtr.get() << experimental.str();
     *streamPtr.get() << "$print_stats = 1 if $examine;" << endl;
     *streamPtr.get() << "$no_output = 1 if $examine;" << endl_2;
     *streamPtr.get() << "# Whitelist of cuda[A-Z] identifiers, which are commonly used in CUDA sources but don't map to any CUDA API:" << endl;
@@ -342,124 +356,145 @@ namespace perl {
     *streamPtr.get() << "}" << endl;
   }
 
-  void generateExperimentalSubstitutions(unique_ptr<ostream> &streamPtr) {
-    *streamPtr.get() << endl << sub << sExperimentalSubstitutions << " {" << endl;
-    for (int i = 0; i < NUM_CONV_TYPES; ++i) {
-      if (i == CONV_INCLUDE_CUDA_MAIN_H || i == CONV_INCLUDE_CUDA_MAIN_V2_H || i == CONV_INCLUDE) {
-        for (auto &ma : CUDA_INCLUDE_MAP) {
-          if (!Statistics::isHipExperimental(ma.second)) continue;
-          if (i == ma.second.type) {
-            string sCUDA = ma.first.str();
-            string sHIP = ma.second.hipName.str();
-            sCUDA = regex_replace(sCUDA, regex("/"), "\\/");
-            sHIP = regex_replace(sHIP, regex("/"), "\\/");
-            *streamPtr.get() << tab << "subst(\"" << sCUDA << "\", \"" << sHIP << "\", \"" << counterNames[ma.second.type] << "\");" << endl;
-          }
-        }
-      } else {
-        for (auto &ma : CUDA_RENAMES_MAP()) {
-          if (!Statistics::isHipExperimental(ma.second)) continue;
-          if (i == ma.second.type) {
-            *streamPtr.get() << tab << "subst(\"" << ma.first.str() << "\", \"" << ma.second.hipName.str() << "\", \"" << counterNames[ma.second.type] << "\");" << endl;
-          }
-        }
-      }
+  void generateIncludeSubstitutions(unique_ptr<ostream> &streamPtr, const string &sFunc, RenameSet renameSet) {
+    *streamPtr.get() << endl << sub << sFunc << " {" << endl;
+    for (auto &r : getIncludeRenames(renameSet)) {
+      string sCUDA = regex_replace(r.cudaName, regex("/"), "\\/");
+      string sHIP = regex_replace(r.hipName, regex("/"), "\\/");
+      *streamPtr.get() << tab << sSubst << "(\"" << sCUDA << "\", \"" << sHIP << "\", \"" << counterNames[r.type] << "\");" << endl;
     }
     *streamPtr.get() << "}" << endl;
   }
 
-  void generateRocSubstitutions(unique_ptr<ostream> &streamPtr) {
-    *streamPtr.get() << endl << sub << sRocSubstitutions << " {" << endl;
-    bool bTranslateToRoc = TranslateToRoc;
-    TranslateToRoc = true;
-    for (int i = 0; i < NUM_CONV_TYPES; ++i) {
-      if (i == CONV_INCLUDE_CUDA_MAIN_H || i == CONV_INCLUDE_CUDA_MAIN_V2_H) {
-        for (auto &ma : CUDA_INCLUDE_MAP) {
-          if (i == ma.second.type) {
-            string sCUDA = ma.first.str();
-            if (sCUDA != "cublas.h" && sCUDA != "cublas_v2.h") continue;
-            string sHIP = ma.second.rocName.str();
-            sCUDA = regex_replace(sCUDA, regex("/"), "\\/");
-            sHIP = regex_replace(sHIP, regex("/"), "\\/");
-            *streamPtr.get() << tab << "subst(\"" << sCUDA << "\", \"" << sHIP << "\", \"" << counterNames[ma.second.type] << "\");" << endl;
-          }
-        }
-      } else {
-        for (auto &ma : CUDA_RENAMES_MAP()) {
-          if (ma.second.apiType != API_BLAS || Statistics::isUnsupported(ma.second) || ma.second.rocName.empty()) continue;
-          if (i == ma.second.type) {
-            *streamPtr.get() << tab << "subst(\"" << ma.first.str() << "\", \"" << ma.second.rocName.str() << "\", \"" << counterNames[ma.second.type] << "\");" << endl;
-          }
-        }
+  void generateNames(unique_ptr<ostream> &streamPtr, const string &sNames, RenameSet renameSet, set<string> &prefixes, Modules &modules) {
+    if (GeneratePerlModules) *streamPtr.get() << endl << my << "%" << sNames << ";" << endl;
+    else *streamPtr.get() << endl << my << "%" << sNames << " = (" << endl;
+    unsigned int count = 0;
+    for (auto &r : getNameRenames(renameSet)) {
+      string sEntry = "\"" + r.cudaName + "\" => [\"" + r.hipName + "\", \"" + counterNames[r.type] + "\"]";
+      prefixes.insert(r.cudaName.substr(0, 2));
+      if (GeneratePerlModules) {
+        getModule(modules, r.cudaName).entries[sNames].push_back(sEntry);
+        continue;
       }
+      *streamPtr.get() << (count ? ",\n" : "") << tab << sEntry;
+      count++;
     }
-    TranslateToRoc = bTranslateToRoc;
-    *streamPtr.get() << "}" << endl;
+    if (!GeneratePerlModules) *streamPtr.get() << endl << ");" << endl;
   }
 
-  void generateSimpleSubstitutions(unique_ptr<ostream> &streamPtr) {
-    *streamPtr.get() << endl << sub << sSimpleSubstitutions << " {" << endl;
-    for (int i = 0; i < NUM_CONV_TYPES; ++i) {
-      if (i == CONV_INCLUDE_CUDA_MAIN_H || i == CONV_INCLUDE_CUDA_MAIN_V2_H || i == CONV_INCLUDE) {
-        for (auto &ma : CUDA_INCLUDE_MAP) {
-          if (Statistics::isUnsupported(ma.second) || Statistics::isHipExperimental(ma.second)) continue;
-          if (i == ma.second.type) {
-            string sCUDA = ma.first.str();
-            string sHIP = ma.second.hipName.str();
-            sCUDA = regex_replace(sCUDA, regex("/"), "\\/");
-            sHIP = regex_replace(sHIP, regex("/"), "\\/");
-            *streamPtr.get() << tab << "subst(\"" << sCUDA << "\", \"" << sHIP << "\", \"" << counterNames[ma.second.type] << "\");" << endl;
-          }
-        }
-      } else {
-        for (auto &ma : CUDA_RENAMES_MAP()) {
-          if (Statistics::isUnsupported(ma.second) || Statistics::isHipExperimental(ma.second)) continue;
-          if (i == ma.second.type) {
-            *streamPtr.get() << tab << "subst(\"" << ma.first.str() << "\", \"" << ma.second.hipName.str() << "\", \"" << counterNames[ma.second.type] << "\");" << endl;
-          }
-        }
-      }
-    }
+  // All the CUDA identifiers are substituted in a single pass over the file: every word, starting with one of the identifiers' prefixes,
+  // is looked up in the %names hash, which is merged from the simple, experimental, and roc hashes according to the options.
+  void generateNameSubstitutions(unique_ptr<ostream> &streamPtr, Modules &modules) {
+    set<string> prefixes;
+    *streamPtr.get() << endl << "# CUDA identifier => [HIP identifier, conversion type]";
+    generateNames(streamPtr, sSimpleNames, rs_Simple, prefixes, modules);
+    generateNames(streamPtr, sExperimentalNames, rs_Experimental, prefixes, modules);
+    generateNames(streamPtr, sRocNames, rs_Roc, prefixes, modules);
+    *streamPtr.get() << endl << my << "%names;" << endl;
+    *streamPtr.get() << endl << sub << sSubstName << " {" << endl;
+    *streamPtr.get() << tab << my << "$a = shift();" << endl;
+    *streamPtr.get() << tab << my << "($b, $t) = @{$names{$a}};" << endl;
+    *streamPtr.get() << tab << "$ft{$t}++;" << endl;
+    *streamPtr.get() << tab << "$tags{$a}++;" << endl;
+    *streamPtr.get() << tab << "$tagsTotal{$a}++;" << endl;
+    *streamPtr.get() << tab << "$convertedTags{$b}++;" << endl;
+    *streamPtr.get() << tab << "$convertedTagsTotal{$b}++;" << endl;
+    *streamPtr.get() << tab << "$tagsToConvertedTags{$a} = $b;" << endl;
+    *streamPtr.get() << tab << "$tagsToConvertedTagsTotal{$a} = $b;" << endl;
+    *streamPtr.get() << tab << "return $b;" << endl;
+    *streamPtr.get() << "}" << endl;
+    string sPrefixes;
+    for (auto &p : prefixes) sPrefixes += (sPrefixes.empty() ? "" : "|") + p;
+    *streamPtr.get() << endl << sub << sNameSubstitutions << " {" << endl;
+    *streamPtr.get() << tab << "s/\\b((?:" << sPrefixes << ")\\w*)\\b/exists $names{$1} ? " << sSubstName << "($1) : $1/ge;" << endl;
     *streamPtr.get() << "}" << endl;
   }
 
+  // Kernel launches are rewritten in a single linear pass: the launch configuration is split by the top-level commas while scanning for
+  // the closing '>>>', and each of its arguments is checked against the argument pattern of the previously used regexes.
   void generateKernelLaunch(unique_ptr<ostream> &streamPtr) {
     *streamPtr.get() << endl << "# CUDA Kernel Launch Syntax" << endl << sub << sTransformKernelLaunch << " {" << endl;
     *streamPtr.get() << tab << no_warns << endl;
-    *streamPtr.get() << tab << my_k << endl_2;
-
-    string s_k = "$k += s/([:|\\w]+)\\s*";
-
-    *streamPtr.get() << tab << "# kern<...><<<Dg, Db, Ns, S>>>() syntax" << endl;
-    *streamPtr.get() << tab << s_k << "<(.+)>\\s*<<<\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*>>>\\s*\\(\\s*\\)/hipLaunchKernelGGL(HIP_KERNEL_NAME($1<$2>), $3, $4, $5, $6)/g;" << endl;
-    *streamPtr.get() << tab << "# kern<...><<<Dg, Db, Ns, S>>>(...) syntax" << endl;
-    *streamPtr.get() << tab << s_k << "<(.+)>\\s*<<<\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*>>>\\s*\\(/hipLaunchKernelGGL(HIP_KERNEL_NAME($1<$2>), $3, $4, $5, $6, /g;" << endl;
-    *streamPtr.get() << tab << "# kern<<<Dg, Db, Ns, S>>>() syntax" << endl;
-    *streamPtr.get() << tab << s_k << "<<<\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*>>>\\s*\\(\\s*\\)/hipLaunchKernelGGL($1, $2, $3, $4, $5)/g;" << endl;
-    *streamPtr.get() << tab << "# kern<<<Dg, Db, Ns, S>>>(...) syntax" << endl;
-    *streamPtr.get() << tab << s_k << "<<<\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*>>>\\s*\\(/hipLaunchKernelGGL($1, $2, $3, $4, $5, /g;" << endl_2;
-
-    *streamPtr.get() << tab << "# kern<...><<<Dg, Db, Ns>>>() syntax" << endl;
-    *streamPtr.get() << tab << s_k << "<(.+)>\\s*<<<\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*>>>\\s*\\(\\s*\\)/hipLaunchKernelGGL(HIP_KERNEL_NAME($1<$2>), $3, $4, $5, 0)/g;" << endl;
-    *streamPtr.get() << tab << "# kern<...><<<Dg, Db, Ns>>>(...) syntax" << endl;
-    *streamPtr.get() << tab << s_k << "<(.+)>\\s*<<<\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*>>>\\s*\\(/hipLaunchKernelGGL(HIP_KERNEL_NAME($1<$2>), $3, $4, $5, 0, /g;" << endl;
-    *streamPtr.get() << tab << "# kern<<<Dg, Db, Ns>>>() syntax" << endl;
-    *streamPtr.get() << tab << s_k << "<<<\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*>>>\\s*\\(\\s*\\)/hipLaunchKernelGGL($1, $2, $3, $4, 0)/g;" << endl;
-    *streamPtr.get() << tab << "# kern<<<Dg, Db, Ns>>>(...) syntax" << endl;
-    *streamPtr.get() << tab << s_k << "<<<\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*>>>\\s*\\(/hipLaunchKernelGGL($1, $2, $3, $4, 0, /g;" << endl_2;
-
-    *streamPtr.get() << tab << "# kern<...><<<Dg, Db>>>() syntax" << endl;
-    *streamPtr.get() << tab << s_k << "<(.+)>\\s*<<<\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*>>>\\s*\\(\\s*\\)/hipLaunchKernelGGL(HIP_KERNEL_NAME($1<$2>), $3, $4, 0, 0)/g;" << endl;
-    *streamPtr.get() << tab << "# kern<...><<<Dg, Db>>>(...) syntax" << endl;
-    *streamPtr.get() << tab << s_k << "<(.+)>\\s*<<<\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*>>>\\s*\\(/hipLaunchKernelGGL(HIP_KERNEL_NAME($1<$2>), $3, $4, 0, 0, /g;" << endl;
-    *streamPtr.get() << tab << "# kern<<<Dg, Db>>>() syntax" << endl;
-    *streamPtr.get() << tab << s_k << "<<<\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*>>>\\s*\\(\\s*\\)/hipLaunchKernelGGL($1, $2, $3, 0, 0)/g;" << endl;
-    *streamPtr.get() << tab << "# kern<<<Dg, Db>>>(...) syntax" << endl;
-    *streamPtr.get() << tab << s_k << "<<<\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*,\\s*([^,\\(\\)]+|[\\w\\s:]*\\([\\w|\\s|,|:|\\+|\\*|\\-|\\/|(?R)]+\\))\\s*>>>\\s*\\(/hipLaunchKernelGGL($1, $2, $3, 0, 0, /g;" << endl_2;
-
+    *streamPtr.get() << tab << my_k << endl;
+    *streamPtr.get() << tab << "# The launches are found and rewritten in a single left-to-right pass: $res accumulates the rewritten text up to $done" << endl;
+    *streamPtr.get() << tab << "my $res = \"\";" << endl;
+    *streamPtr.get() << tab << "my $done = 0;" << endl;
+    *streamPtr.get() << tab << "while (/<<</g) {" << endl;
+    *streamPtr.get() << tab_2 << "my $launch = $-[0];" << endl;
+    *streamPtr.get() << tab_2 << "pos() = $launch + 3;" << endl;
+    *streamPtr.get() << tab_2 << "# Scan the launch configuration up to '>>>', splitting it by the commas outside of parentheses" << endl;
+    *streamPtr.get() << tab_2 << "my @args = ();" << endl;
+    *streamPtr.get() << tab_2 << "my $depth = 0;" << endl;
+    *streamPtr.get() << tab_2 << "my $i = $launch + 3;" << endl;
+    *streamPtr.get() << tab_2 << "my $argStart = $i;" << endl;
+    *streamPtr.get() << tab_2 << "my $configEnd = -1;" << endl;
+    *streamPtr.get() << tab_2 << "for (my $len = length($_); $i < $len; ++$i) {" << endl;
+    *streamPtr.get() << tab_3 << "my $c = substr($_, $i, 1);" << endl;
+    *streamPtr.get() << tab_3 << "if ($c eq '(') {" << endl;
+    *streamPtr.get() << tab_4 << "$depth++;" << endl;
+    *streamPtr.get() << tab_3 << "} elsif ($c eq ')') {" << endl;
+    *streamPtr.get() << tab_4 << "last if !$depth;" << endl;
+    *streamPtr.get() << tab_4 << "$depth--;" << endl;
+    *streamPtr.get() << tab_3 << "} elsif ($depth) {" << endl;
+    *streamPtr.get() << tab_4 << "next;" << endl;
+    *streamPtr.get() << tab_3 << "} elsif ($c eq ',') {" << endl;
+    *streamPtr.get() << tab_4 << "push(@args, substr($_, $argStart, $i - $argStart));" << endl;
+    *streamPtr.get() << tab_4 << "$argStart = $i + 1;" << endl;
+    *streamPtr.get() << tab_3 << "} elsif ($c eq '>' and substr($_, $i, 3) eq '>>>') {" << endl;
+    *streamPtr.get() << tab_4 << "push(@args, substr($_, $argStart, $i - $argStart));" << endl;
+    *streamPtr.get() << tab_4 << "$configEnd = $i + 3;" << endl;
+    *streamPtr.get() << tab_4 << "last;" << endl;
+    *streamPtr.get() << tab_3 << "} elsif ($c eq ';' or $c eq '{' or $c eq '}' or ($c eq '<' and substr($_, $i, 3) eq '<<<')) {" << endl;
+    *streamPtr.get() << tab_4 << "last;" << endl;
+    *streamPtr.get() << tab_3 << "}" << endl;
+    *streamPtr.get() << tab_2 << "}" << endl;
+    *streamPtr.get() << tab_2 << "next if $configEnd < 0 or @args < 2 or @args > 4;" << endl;
+    *streamPtr.get() << tab_2 << "my $valid = 1;" << endl;
+    *streamPtr.get() << tab_2 << "foreach my $arg (@args) {" << endl;
+    *streamPtr.get() << tab_3 << "$arg =~ s/^\\s*(\\s)\\z/$1/ or $arg =~ s/^\\s+//;" << endl;
+    *streamPtr.get() << tab_3 << "# an argument with parentheses is either a call or a constructor like dim3(x, y)" << endl;
+    *streamPtr.get() << tab_3 << "if ($arg =~ /[()]/) {" << endl;
+    *streamPtr.get() << tab_4 << "$valid = 0 unless $arg =~ s/^([\\w\\s:]*\\([\\w|\\s,:+*\\-\\/(?R)]+\\))\\s*\\z/$1/;" << endl;
+    *streamPtr.get() << tab_3 << "}" << endl;
+    *streamPtr.get() << tab_3 << "$valid = 0 if $arg eq '';" << endl;
+    *streamPtr.get() << tab_2 << "}" << endl;
+    *streamPtr.get() << tab_2 << "next unless $valid;" << endl;
+    *streamPtr.get() << tab_2 << "# The kernel arguments: either an empty list, which is consumed, or the opening parenthesis only" << endl;
+    *streamPtr.get() << tab_2 << "pos() = $configEnd;" << endl;
+    *streamPtr.get() << tab_2 << "my $call = /\\G\\s*\\((\\s*\\))?/gc;" << endl;
+    *streamPtr.get() << tab_2 << "my $callEnd = pos();" << endl;
+    *streamPtr.get() << tab_2 << "my $noArgs = defined $1;" << endl;
+    *streamPtr.get() << tab_2 << "pos() = $launch + 3;" << endl;
+    *streamPtr.get() << tab_2 << "next unless $call;" << endl;
+    *streamPtr.get() << tab_2 << "# The kernel name with optional template arguments, which are on the same line with the launch" << endl;
+    *streamPtr.get() << tab_2 << "my $name;" << endl;
+    *streamPtr.get() << tab_2 << "my $nameStart;" << endl;
+    *streamPtr.get() << tab_2 << "my $from = rindex($_, \"\\n\", $launch - 1);" << endl;
+    *streamPtr.get() << tab_2 << "$from = rindex($_, \"\\n\", $from - 1) if $from > 0;" << endl;
+    *streamPtr.get() << tab_2 << "$from = $done if $from < $done;" << endl;
+    *streamPtr.get() << tab_2 << "my $before = substr($_, $from, $launch - $from);" << endl;
+    *streamPtr.get() << tab_2 << "if ($before =~ /([:|\\w]+)\\s*\\z/) {" << endl;
+    *streamPtr.get() << tab_3 << "$name = $1;" << endl;
+    *streamPtr.get() << tab_3 << "$nameStart = $from + $-[1];" << endl;
+    *streamPtr.get() << tab_2 << "} elsif ($before =~ /^.*?([:|\\w]+)\\s*<([^\\n]+)>\\s*\\z/s) {" << endl;
+    *streamPtr.get() << tab_3 << "$name = \"HIP_KERNEL_NAME($1<$2>)\";" << endl;
+    *streamPtr.get() << tab_3 << "$nameStart = $from + $-[1];" << endl;
+    *streamPtr.get() << tab_2 << "} else {" << endl;
+    *streamPtr.get() << tab_3 << "next;" << endl;
+    *streamPtr.get() << tab_2 << "}" << endl;
+    *streamPtr.get() << tab_2 << "$k++;" << endl;
+    *streamPtr.get() << tab_2 << "$Tkernels{$name}++;" << endl;
+    *streamPtr.get() << tab_2 << "my @config = (@args, ('0') x (4 - @args));" << endl;
+    *streamPtr.get() << tab_2 << "$res .= substr($_, $done, $nameStart - $done) . \"hipLaunchKernelGGL($name, \" . join(', ', @config) . ($noArgs ? \")\" : \", \");" << endl;
+    *streamPtr.get() << tab_2 << "$done = $callEnd;" << endl;
+    *streamPtr.get() << tab_2 << "pos() = $done;" << endl;
+    *streamPtr.get() << tab << "}" << endl;
     *streamPtr.get() << tab << "if ($k) {" << endl;
+    *streamPtr.get() << tab_2 << "$_ = $res . substr($_, $done);" << endl;
     *streamPtr.get() << tab_2 << "$ft{'kernel_launch'} += $k;" << endl;
-    *streamPtr.get() << tab_2 << "$Tkernels{$1}++;" << endl_tab << "}" << endl << "}" << endl;
+    *streamPtr.get() << tab << "}" << endl;
+    *streamPtr.get() << tab << return_k << "}" << endl;
   }
 
   void generateCubNamespace(unique_ptr<ostream> &streamPtr) {
@@ -470,152 +505,81 @@ namespace perl {
 
   void generateHostFunctions(unique_ptr<ostream> &streamPtr) {
     *streamPtr.get() << endl << sub << "transformHostFunctions" << " {" << endl_tab << my_k << endl;
-    const string s = "$k += s/(?<!\\/\\/ CHECK: )($func)\\s*";
-    const string s0 = s + "\\(([^,\\)]+),/$func\\(";
-    const string s1 = s + "\\(([^,\\)]+),([\\s]*)([^,\\)]+)(,\\s*|\\))/$func\\($2,$3";
-    const string s2 = s + "\\(([^,\\)]+),([^,\\)]+),([\\s]*)([^,\\)]+)(,\\s*|\\))/$func\\($2,$3,$4";
-    const string s3 = s + "\\(([^,\\)]+),([^,\\)]+),([^,\\)]+),([\\s]*)([^,\\)]+)(,\\s*|\\))/$func\\($2,$3,$4";
-    const string s4 = s + "\\(([^,\\)]+),([^,\\)]+),([^,\\)]+),([^,\\)]+),([\\s]*)([^,\\)]+)(,\\s*|\\))/$func\\($2,$3,$4,$5,$6";
-    const string s5 = s + "\\(([^,\\)]+),([^,\\)]+),([^,\\)]+),([^,\\)]+),([^,\\)]+),([\\s]*)([^,\\)]+)(,\\s*|\\))/$func\\($2,$3,$4,$5,$6,$7";
-    set<string> DeviceSymbolFunctions0;
-    set<string> DeviceSymbolFunctions1;
-    set<string> DeviceSymbolFunctions2;
-    set<string> DeviceSymbolFunctions3;
-    set<string> DeviceSymbolFunctions4;
-    set<string> DeviceSymbolFunctions5;
-    set<string> ReinterpretFunctions0;
-    set<string> ReinterpretFunctions1;
-    set<string> RemoveArgFunctions3;
-    for (auto f : FuncArgCasts) {
-      auto casts = f.second;
-      for (auto c : casts) {
-        switch (c.first) {
-          case 0:
-            switch (c.second.castType) {
-              case e_HIP_SYMBOL: DeviceSymbolFunctions0.insert(f.first); break;
-              case e_reinterpret_cast: ReinterpretFunctions0.insert(f.first); break;
-              default: break;
-            }
-            break;
-          case 1:
-            switch (c.second.castType) {
-              case e_HIP_SYMBOL: DeviceSymbolFunctions1.insert(f.first); break;
-              case e_reinterpret_cast: ReinterpretFunctions1.insert(f.first); break;
-              default: break;
-            }
-            break;
-          case 2:
-            switch (c.second.castType) {
-              case e_HIP_SYMBOL: DeviceSymbolFunctions2.insert(f.first); break;
-              default: break;
-            }
-            break;
-          case 3:
-            switch (c.second.castType) {
-              case e_HIP_SYMBOL: DeviceSymbolFunctions3.insert(f.first); break;
-              case e_remove_argument: RemoveArgFunctions3.insert(f.first); break;
-              default: break;
-            }
-            break;
-          case 4:
-            switch (c.second.castType) {
-            case e_HIP_SYMBOL: DeviceSymbolFunctions4.insert(f.first); break;
-            default: break;
-            }
-            break;
-          case 5:
-            switch (c.second.castType) {
-            case e_HIP_SYMBOL: DeviceSymbolFunctions5.insert(f.first); break;
-            default: break;
-            }
-            break;
-          default: break;
-        }
-      }
-    }
-    set<string>& funcSet = DeviceSymbolFunctions0;
-    for (int i = 0; i < 9; ++i) {
-      switch (i) {
-        default: funcSet = DeviceSymbolFunctions0; break;
-        case 1:  funcSet = DeviceSymbolFunctions1; break;
-        case 2:  funcSet = ReinterpretFunctions0; break;
-        case 3:  funcSet = ReinterpretFunctions1; break;
-        case 4:  funcSet = DeviceSymbolFunctions2; break;
-        case 5:  funcSet = RemoveArgFunctions3; break;
-        case 6:  funcSet = DeviceSymbolFunctions3; break;
-        case 7:  funcSet = DeviceSymbolFunctions4; break;
-        case 8:  funcSet = DeviceSymbolFunctions5; break;
-      }
-      if (funcSet.empty()) continue;
+    const string sArg = "([^,\\)]+),";
+    for (auto &r : getArgRewrites()) {
+      if (r.funcs.empty()) continue;
       *streamPtr.get() << tab + foreach_func;
       unsigned int count = 0;
-      string sHIPName;
-      for (auto &f : funcSet) {
-        const auto found = CUDA_RUNTIME_FUNCTION_MAP.find(f);
-        if (found != CUDA_RUNTIME_FUNCTION_MAP.end()) sHIPName = found->second.hipName.str();
-        else {
-          const auto found2 = CUDA_DRIVER_FUNCTION_MAP.find(f);
-          if (found2 != CUDA_DRIVER_FUNCTION_MAP.end()) sHIPName = found2->second.hipName.str();
-        }
-        *streamPtr.get() << (count ? ",\n" : "") << tab_2 << "\"" << sHIPName << "\"";
-        count++;
-      }
+      for (auto &f : r.funcs) *streamPtr.get() << (count++ ? ",\n" : "") << tab_2 << "\"" << f << "\"";
       *streamPtr.get() << endl_tab << ")" << endl_tab << "{" << endl_tab_2;
-      switch (i) {
-        case 0:
-        default: *streamPtr.get() << s0 << getCastType(e_HIP_SYMBOL) << "\\($2\\),/g;" << endl; break;
-        case 1:  *streamPtr.get() << s1 << getCastType(e_HIP_SYMBOL) << "\\($4\\)$5/g;" << endl; break;
-        case 2:  *streamPtr.get() << s0 << getCastType(e_reinterpret_cast) << "\\($2\\),/g;" << endl; break;
-        case 3:  *streamPtr.get() << s1 << getCastType(e_reinterpret_cast) << "\\($4\\)$5/g;" << endl; break;
-        case 4:  *streamPtr.get() << s2 << getCastType(e_HIP_SYMBOL) << "\\($5\\)$6/g;" << endl; break;
-        case 5:  *streamPtr.get() << s3 << "$7/g;" << endl; break;
-        case 6:  *streamPtr.get() << s3 << ",$5" << getCastType(e_HIP_SYMBOL) << "\\($6\\)$7/g;" << endl; break;
-        case 7:  *streamPtr.get() << s4 << getCastType(e_HIP_SYMBOL) << "\\($7\\)$8/g;" << endl; break;
-        case 8:  *streamPtr.get() << s5 << getCastType(e_HIP_SYMBOL) << "\\($8\\)$9/g;" << endl; break;
+      // The first argument is followed by a comma; any other one is preceded by the previous arguments and followed by a comma or a parenthesis.
+      string sMatch = "$k += s/(?<!\\/\\/ CHECK: )($func)\\s*\\(", sSubst = "/$func\\(";
+      for (unsigned i = 0; i < r.argNum; ++i) {
+        sMatch += sArg;
+        sSubst += (i ? ",$" : "$") + to_string(i + 2);
+      }
+      if (!r.argNum) {
+        *streamPtr.get() << sMatch << sArg << sSubst << getCastType(r.castType) << "\\($2\\),/g;" << endl;
+      } else {
+        sMatch += "([\\s]*)([^,\\)]+)(,\\s*|\\))";
+        if (r.castType == e_remove_argument) sSubst += "$" + to_string(r.argNum + 4);
+        else sSubst += ",$" + to_string(r.argNum + 2) + getCastType(r.castType) + "\\($" + to_string(r.argNum + 3) + "\\)$" + to_string(r.argNum + 4);
+        *streamPtr.get() << sMatch << sSubst << "/g;" << endl;
       }
       *streamPtr.get() << tab << "}" << endl;
     }
     *streamPtr.get() << tab << return_k << "}" << endl;
   }
 
-  void generateDeprecatedAndUnsupportedFunctions(unique_ptr<ostream> &streamPtr) {
+  void generateDeprecatedAndUnsupportedFunctions(unique_ptr<ostream> &streamPtr, Modules &modules) {
     stringstream sDeprecated, sRemoved, sUnsupported, sRocUnsupported, sHipUnsupported, sExperimental, sCommon, sCommon1;
-    sCommon << tab << my << "$line_num = shift;" << endl;
-    sCommon << tab << my_k << endl;
-    string sWhile = "while (my($func, $val) = each ";
-    sExperimental << endl << sub << sWarnExperimentalFunctions << " {" << endl << sCommon.str() << tab << sWhile << "%experimental_funcs)" << endl;
-    sDeprecated << endl << sub << sWarnDeprecatedFunctions << " {" << endl << sCommon.str() << tab << sWhile << "%deprecated_funcs)" << endl;
-    sRemoved << endl << sub << sWarnRemovedFunctions << " {" << endl << sCommon.str() << tab << sWhile << "%removed_funcs)" << endl;
-    sUnsupported << endl << sub << sWarnUnsupportedFunctions << " {" << endl << sCommon.str() << tab << foreach_func;
-    sRocUnsupported << endl << sub << sWarnRocOnlyUnsupportedFunctions << " {" << endl << sCommon.str() << tab << foreach_func;
-    sHipUnsupported << endl << sub << sWarnHipOnlyUnsupportedFunctions << " {" << endl << sCommon.str() << tab << foreach_func;
-    unsigned int countUnsupported = 0, countRocOnlyUnsupported = 0, countHipOnlyUnsupported = 0;
-    bool bTranslateToRoc = TranslateToRoc;
-    for (auto ma = CUDA_RENAMES_MAP().rbegin(); ma != CUDA_RENAMES_MAP().rend(); ++ma) {
-      TranslateToRoc = false;
-      if (Statistics::isUnsupported(ma->second)) {
-        if (ma->second.apiType == API_BLAS) {
-          sHipUnsupported << (countHipOnlyUnsupported ? ",\n" : "") << tab_2 << "\"" << ma->first.str() << "\"";
-          countHipOnlyUnsupported++;
-        } else {
-          sUnsupported << (countUnsupported ? ",\n" : "") << tab_2 << "\"" << ma->first.str() << "\"";
-          countUnsupported++;
-        }
+    vector<string> unsupported, rocUnsupported, hipUnsupported;
+    getUnsupportedNames(unsupported, hipUnsupported, rocUnsupported);
+    VersionedNames deprecated, removed, experimental;
+    getVersionedNames(deprecated, removed, experimental);
+    // Each line is matched against a single trie regex of the category first, and only then, if matched, against every name.
+    // With the modules, the names and the regex of the category are added by every loaded module.
+    auto header = [&modules](const string &sFunc, const string &sNames, const vector<string> &names, bool bList) {
+      if (GeneratePerlModules)
+        for (auto &n : names) getModule(modules, n).warnNames[sNames].push_back(n);
+      return "\n" + my + "$" + sNames + "_regex = qr/" + getNamesRegex(GeneratePerlModules ? vector<string>() : names) + "/;\n" +
+        (GeneratePerlModules && bList ? my + "@" + sNames + ";\n" : "") + "\n" + sub + sFunc + " {\n" +
+        tab + my + "$line_num = shift;\n" + tab + "return 0 unless /$" + sNames + "_regex/;\n" + tab + my_k + "\n";
+    };
+    auto versioned = [&modules](const string &sNames, const VersionedNames &names) {
+      if (GeneratePerlModules)
+        for (auto &n : names) getModule(modules, n.first).entries[sNames].push_back("\"" + n.first + "\" => \"" + n.second + "\"");
+      return getNames(names);
+    };
+    // The modules' lists are merged in the order of the names in the whole list, and a gap in the order stands for the names of the modules,
+    // which are not loaded: such a name is not in the source, so it is not matched, and the failed match resets the position of the next one.
+    auto list = [&modules](stringstream &s, const string &sNames, const vector<string> &names) {
+      if (!GeneratePerlModules) {
+        s << tab << foreach_func;
+        for (auto &n : names) s << (&n != &names.front() ? ",\n" : "") << tab_2 << "\"" << n << "\"";
+        s << endl_tab << ")" << endl << tab << "{" << endl;
+        return;
       }
-      TranslateToRoc = true;
-      if (Statistics::isUnsupported(ma->second)) {
-        if (ma->second.apiType == API_BLAS) {
-          sRocUnsupported << (countRocOnlyUnsupported ? ",\n" : "") << tab_2 << "\"" << ma->first.str() << "\"";
-          countRocOnlyUnsupported++;
-        }
-      }
-    }
-    TranslateToRoc = bTranslateToRoc;
-    sCommon.str(std::string());
-    sUnsupported << endl_tab << ")" << endl;
-    sHipUnsupported << endl_tab << ")" << endl;
-    sRocUnsupported << endl_tab << ")" << endl;
-    sCommon << tab << "{" << endl;
+      for (size_t i = 0; i < names.size(); ++i) getModule(modules, names[i]).entries[sNames].push_back("[" + to_string(i) + ", \"" + names[i] + "\"]");
+      s << tab << my << "$last = -1;" << endl;
+      s << tab << foreach << my << "$entry (@" << sNames << ")" << endl << tab << "{" << endl;
+      s << tab_2 << my << "($index, $func) = @$entry;" << endl;
+      s << tab_2 << "pos() = undef if $index != $last + 1;" << endl;
+      s << tab_2 << "$last = $index;" << endl;
+    };
+    auto listEnd = [](const vector<string> &names) {
+      return GeneratePerlModules ? tab + "pos() = undef if $last != " + to_string(static_cast<int>(names.size()) - 1) + ";\n" : "";
+    };
+    string sWhile = "while (my($func, $val) = each ";
+    sExperimental << header(sWarnExperimentalFunctions, "experimental_funcs", versioned("experimental_funcs", experimental), false) << tab << sWhile << "%experimental_funcs)" << endl << tab << "{" << endl;
+    sDeprecated << header(sWarnDeprecatedFunctions, "deprecated_funcs", versioned("deprecated_funcs", deprecated), false) << tab << sWhile << "%deprecated_funcs)" << endl << tab << "{" << endl;
+    sRemoved << header(sWarnRemovedFunctions, "removed_funcs", versioned("removed_funcs", removed), false) << tab << sWhile << "%removed_funcs)" << endl << tab << "{" << endl;
+    sUnsupported << header(sWarnUnsupportedFunctions, "unsupported_funcs", unsupported, true);
+    sRocUnsupported << header(sWarnRocOnlyUnsupportedFunctions, "roc_unsupported_funcs", rocUnsupported, true);
+    sHipUnsupported << header(sWarnHipOnlyUnsupportedFunctions, "hip_unsupported_funcs", hipUnsupported, true);
+    list(sUnsupported, "unsupported_funcs", unsupported);
+    list(sHipUnsupported, "hip_unsupported_funcs", hipUnsupported);
+    list(sRocUnsupported, "roc_unsupported_funcs", rocUnsupported);
     sCommon << tab_2 << my << "$mt = m/($func)/g;" << endl;
     sCommon << tab_2 << "if ($mt) {" << endl;
     sCommon << tab_3 << "$k += $mt;" << endl;
@@ -631,13 +595,14 @@ namespace perl {
     sHipUnsupported << sCommon.str();
     sRocUnsupported << sCommon.str();
     sCommon.str(std::string());
-    sCommon << tab_2 << "}\n" << tab << "}\n" << tab << return_k << "}" << endl;
-    sExperimental << tab_3 << print << "\"  "  << warning << "experimental identifier \\\"$func\\\" in HIP $val\\n\";" << endl << sCommon.str();
-    sDeprecated << tab_3 << print << "\"  "  << warning << "deprecated identifier \\\"$func\\\" since $cuda $val\\n\";" << endl << sCommon.str();
-    sRemoved << tab_3 << print << "\"  "  << warning << "removed identifier \\\"$func\\\" since $cuda $val\\n\";" << endl << sCommon.str();
-    sUnsupported << tab_3 << print << "\"  "  << warning << "unsupported identifier \\\"$func\\\"\\n\";" << endl << sCommon.str();
-    sHipUnsupported << tab_3 << print << "\"  "  << warning << "unsupported identifier \\\"$func\\\"\\n\";" << endl << sCommon.str();
-    sRocUnsupported << tab_3 << print << "\"  "  << warning << "unsupported by ROC identifier \\\"$func\\\"\\n\";" << endl << sCommon.str();
+    sCommon << tab_2 << "}\n" << tab << "}\n";
+    string sReturn = tab + return_k + "}\n";
+    sExperimental << tab_3 << print << "\"  "  << warning << "experimental identifier \\\"$func\\\" in HIP $val\\n\";" << endl << sCommon.str() << sReturn;
+    sDeprecated << tab_3 << print << "\"  "  << warning << "deprecated identifier \\\"$func\\\" since $cuda $val\\n\";" << endl << sCommon.str() << sReturn;
+    sRemoved << tab_3 << print << "\"  "  << warning << "removed identifier \\\"$func\\\" since $cuda $val\\n\";" << endl << sCommon.str() << sReturn;
+    sUnsupported << tab_3 << print << "\"  "  << warning << "unsupported identifier \\\"$func\\\"\\n\";" << endl << sCommon.str() << listEnd(unsupported) << sReturn;
+    sHipUnsupported << tab_3 << print << "\"  "  << warning << "unsupported identifier \\\"$func\\\"\\n\";" << endl << sCommon.str() << listEnd(hipUnsupported) << sReturn;
+    sRocUnsupported << tab_3 << print << "\"  "  << warning << "unsupported by ROC identifier \\\"$func\\\"\\n\";" << endl << sCommon.str() << listEnd(rocUnsupported) << sReturn;
     *streamPtr.get() << sExperimental.str();
     *streamPtr.get() << sDeprecated.str();
     *streamPtr.get() << sRemoved.str();
@@ -646,23 +611,88 @@ namespace perl {
     *streamPtr.get() << sRocUnsupported.str();
   }
 
+  // The driver loads a module once a source contains any of the module's prefixes, and merges the module's data into its own variables.
+  bool generateModules(unique_ptr<ostream> &streamPtr, Modules &modules, const string &dstHipifyPerl) {
+    const vector<string> hashes = { sSimpleNames, sExperimentalNames, sRocNames, "deprecated_funcs", "removed_funcs", "experimental_funcs" };
+    const vector<string> lists = { "unsupported_funcs", "hip_unsupported_funcs", "roc_unsupported_funcs" };
+    const vector<string> categories = { "deprecated_funcs", "removed_funcs", "experimental_funcs", "unsupported_funcs", "hip_unsupported_funcs", "roc_unsupported_funcs" };
+    SmallString<256> modulesDir(sys::path::parent_path(dstHipifyPerl));
+    sys::path::append(modulesDir, sModulesDir);
+    error_code EC = sys::fs::create_directories(modulesDir);
+    if (EC) {
+      llvm::errs() << "\n" << sHipify << sError << EC.message() << ": " << modulesDir << "\n";
+      return false;
+    }
+    *streamPtr.get() << endl << "# Modules of the APIs with the regexes of the first characters of their CUDA identifiers" << endl;
+    *streamPtr.get() << my << "@modules = (" << endl;
+    for (auto &m : modules)
+      *streamPtr.get() << (&m != &*modules.begin() ? ",\n" : "") << tab << "[\"" << m.first << "\", qr/" << getNamesRegex(getModulePrefixes(modules, m.first)) << "/]";
+    *streamPtr.get() << endl << ");" << endl;
+    *streamPtr.get() << my << "%loaded_modules;" << endl;
+    *streamPtr.get() << my << "$modules_dir = dirname(Cwd::realpath($0)) . \"/" << sModulesDir << "\";" << endl;
+    *streamPtr.get() << endl << sub << "loadModules" << " {" << endl;
+    *streamPtr.get() << tab << my << "$loaded = 0;" << endl;
+    *streamPtr.get() << tab << foreach << my << "$module (@modules) {" << endl;
+    *streamPtr.get() << tab_2 << my << "($name, $regex) = @$module;" << endl;
+    *streamPtr.get() << tab_2 << "next if $loaded_modules{$name} or !/$regex/;" << endl;
+    *streamPtr.get() << tab_2 << my << "$file = \"$modules_dir/$name.pl\";" << endl;
+    *streamPtr.get() << tab_2 << my << "$m = do $file;" << endl;
+    *streamPtr.get() << tab_2 << "die \"error: could not load $file: \" . ($@ or $!) . \"\\n\" unless $m;" << endl;
+    *streamPtr.get() << tab_2 << "$loaded_modules{$name} = 1;" << endl;
+    *streamPtr.get() << tab_2 << "$loaded++;" << endl;
+    for (auto &h : hashes) *streamPtr.get() << tab_2 << "%" << h << " = (%" << h << ", %{$m->{" << h << "}});" << endl;
+    for (auto &l : lists) *streamPtr.get() << tab_2 << "@" << l << " = sort { $a->[0] <=> $b->[0] } (@" << l << ", @{$m->{" << l << "}});" << endl;
+    for (auto &c : categories) *streamPtr.get() << tab_2 << "$" << c << "_regex = qr/$" << c << "_regex|$m->{" << c << "_regex}/;" << endl;
+    *streamPtr.get() << tab << "}" << endl;
+    *streamPtr.get() << tab << "%names = (%" << sSimpleNames << ", ($experimental ? %" << sExperimentalNames << " : ()), ($roc ? %" << sRocNames << " : ())) if $loaded;" << endl;
+    *streamPtr.get() << "}" << endl;
+    for (auto &m : modules) {
+      SmallString<256> moduleFile(modulesDir);
+      sys::path::append(moduleFile, m.first + ".pl");
+      ofstream module(moduleFile.c_str(), ios_base::trunc);
+      if (!module) {
+        llvm::errs() << "\n" << sHipify << sError << "could not open " << moduleFile << "\n";
+        return false;
+      }
+      module << sCopyright << endl << sImportant << endl_2;
+      module << "# " << apiNames[m.second.api] << " module of " << hipify_perl << endl;
+      module << "+{" << endl;
+      auto generateEntries = [&](const string &sVar, const string &sOpen, const string &sClose) {
+        auto &entries = m.second.entries[sVar];
+        module << tab << sVar << " => " << sOpen;
+        for (auto &e : entries) module << (&e != &entries.front() ? ",\n" : "\n") << tab_2 << e;
+        module << (entries.empty() ? "" : endl_tab) << sClose << "," << endl;
+      };
+      for (auto &h : hashes) generateEntries(h, "{", "}");
+      for (auto &l : lists) generateEntries(l, "[", "]");
+      for (auto &c : categories) module << tab << c << "_regex => qr/" << getNamesRegex(m.second.warnNames[c]) << "/" << (&c != &categories.back() ? "," : "") << endl;
+      module << "};" << endl;
+    }
+    return true;
+  }
+
   void generateDeviceFunctions(unique_ptr<ostream> &streamPtr) {
     unsigned int countUnsupported = 0;
     unsigned int countSupported = 0;
     stringstream sSupported;
     stringstream sUnsupported;
-    for (auto ma = CUDA_DEVICE_FUNCTION_MAP.rbegin(); ma != CUDA_DEVICE_FUNCTION_MAP.rend(); ++ma) {
-      bool isUnsupported = Statistics::isUnsupported(ma->second);
-      (isUnsupported ? sUnsupported : sSupported) << ((isUnsupported && countUnsupported) || (!isUnsupported && countSupported) ? ",\n" : "") << tab_2 << "\"" << ma->first.str() << "\"";
-      if (isUnsupported) countUnsupported++;
-      else countSupported++;
-    }
+    vector<string> supportedNames, unsupportedNames;
+    getDeviceFunctionNames(supportedNames, unsupportedNames);
+    for (auto &n : supportedNames) sSupported << (countSupported++ ? ",\n" : "") << tab_2 << "\"" << n << "\"";
+    for (auto &n : unsupportedNames) sUnsupported << (countUnsupported++ ? ",\n" : "") << tab_2 << "\"" << n << "\"";
     stringstream subCountSupported;
     stringstream subWarnUnsupported;
     stringstream subCommon;
     string sCommon = tab + my_k + "\n" + tab + foreach_func;
-    subCountSupported << endl << sub << sCountSupportedDeviceFunctions << " {" << endl << (countSupported ? sCommon : tab + return_0);
-    subWarnUnsupported << endl << sub << sWarnUnsupportedDeviceFunctions << " {" << endl << (countUnsupported ? tab + my + "$line_num = shift;\n" + sCommon : tab + return_0);
+    // Only a call of any of the device functions might be matched in the loop below.
+    auto regex = [](const string &sNames, const vector<string> &names) {
+      return "\n" + my + "$" + sNames + "_regex = qr/\\b" + getNamesRegex(names) + "\\b\\s*\\(/;\n";
+    };
+    auto prefilter = [](const string &sNames) { return tab + "return 0 unless /$" + sNames + "_regex/;\n"; };
+    if (countSupported) subCountSupported << regex("supported_device_funcs", supportedNames);
+    if (countUnsupported) subWarnUnsupported << regex("unsupported_device_funcs", unsupportedNames);
+    subCountSupported << endl << sub << sCountSupportedDeviceFunctions << " {" << endl << (countSupported ? prefilter("supported_device_funcs") + sCommon : tab + return_0);
+    subWarnUnsupported << endl << sub << sWarnUnsupportedDeviceFunctions << " {" << endl << (countUnsupported ? tab + my + "$line_num = shift;\n" + prefilter("unsupported_device_funcs") + sCommon : tab + return_0);
     if (countSupported) subCountSupported << sSupported.str() << endl_tab << ")" << endl;
     if (countUnsupported) subWarnUnsupported << sUnsupported.str() << endl_tab << ")" << endl;
     if (countSupported || countUnsupported) {
@@ -688,6 +718,125 @@ namespace perl {
     *streamPtr.get() << subWarnUnsupported.str();
   }
 
+  // The files are distributed among $jobs forked workers only if the output doesn't go to STDOUT or to the same -o file.
+  void generateParallelProcessing(unique_ptr<ostream> &streamPtr) {
+    *streamPtr.get() << endl;
+    *streamPtr.get() << "# Worker's statistics, sent to the parent process in text lines: name, key, and value separated by tabs" << endl;
+    *streamPtr.get() << "sub sendStats {" << endl;
+    *streamPtr.get() << tab << "my $writer = shift;" << endl;
+    *streamPtr.get() << tab << "foreach my $key (keys %tt) {" << endl;
+    *streamPtr.get() << tab_2 << "print $writer \"S tt\\t$key\\t$tt{$key}\\n\";" << endl;
+    *streamPtr.get() << tab << "}" << endl;
+    *streamPtr.get() << tab << "foreach my $key (keys %TwarningTags) {" << endl;
+    *streamPtr.get() << tab_2 << "print $writer \"S TwarningTags\\t$key\\t$TwarningTags{$key}\\n\";" << endl;
+    *streamPtr.get() << tab << "}" << endl;
+    *streamPtr.get() << tab << "foreach my $key (keys %tagsTotal) {" << endl;
+    *streamPtr.get() << tab_2 << "print $writer \"S tagsTotal\\t$key\\t$tagsTotal{$key}\\n\";" << endl;
+    *streamPtr.get() << tab << "}" << endl;
+    *streamPtr.get() << tab << "foreach my $key (keys %convertedTagsTotal) {" << endl;
+    *streamPtr.get() << tab_2 << "print $writer \"S convertedTagsTotal\\t$key\\t$convertedTagsTotal{$key}\\n\";" << endl;
+    *streamPtr.get() << tab << "}" << endl;
+    *streamPtr.get() << tab << "foreach my $key (keys %tagsToConvertedTagsTotal) {" << endl;
+    *streamPtr.get() << tab_2 << "print $writer \"S tagsToConvertedTagsTotal\\t$key\\t$tagsToConvertedTagsTotal{$key}\\n\";" << endl;
+    *streamPtr.get() << tab << "}" << endl;
+    *streamPtr.get() << tab << "print $writer \"S Twarnings\\t\\t$Twarnings\\n\";" << endl;
+    *streamPtr.get() << tab << "print $writer \"S TlineCount\\t\\t$TlineCount\\n\";" << endl;
+    *streamPtr.get() << "}" << endl;
+    *streamPtr.get() << endl;
+    *streamPtr.get() << "sub receiveStats {" << endl;
+    *streamPtr.get() << tab << "my ($name, $key, $value) = @_;" << endl;
+    *streamPtr.get() << tab << "if ($name eq \"tt\") {" << endl;
+    *streamPtr.get() << tab_2 << "$tt{$key} += $value;" << endl;
+    *streamPtr.get() << tab << "} elsif ($name eq \"TwarningTags\") {" << endl;
+    *streamPtr.get() << tab_2 << "$TwarningTags{$key} += $value;" << endl;
+    *streamPtr.get() << tab << "} elsif ($name eq \"tagsTotal\") {" << endl;
+    *streamPtr.get() << tab_2 << "$tagsTotal{$key} += $value;" << endl;
+    *streamPtr.get() << tab << "} elsif ($name eq \"convertedTagsTotal\") {" << endl;
+    *streamPtr.get() << tab_2 << "$convertedTagsTotal{$key} += $value;" << endl;
+    *streamPtr.get() << tab << "} elsif ($name eq \"tagsToConvertedTagsTotal\") {" << endl;
+    *streamPtr.get() << tab_2 << "$tagsToConvertedTagsTotal{$key} = $value;" << endl;
+    *streamPtr.get() << tab << "} elsif ($name eq \"Twarnings\") {" << endl;
+    *streamPtr.get() << tab_2 << "$Twarnings += $value;" << endl;
+    *streamPtr.get() << tab << "} elsif ($name eq \"TlineCount\") {" << endl;
+    *streamPtr.get() << tab_2 << "$TlineCount += $value;" << endl;
+    *streamPtr.get() << tab << "}" << endl;
+    *streamPtr.get() << "}" << endl;
+    *streamPtr.get() << endl;
+    *streamPtr.get() << "# Hipify the files by $jobs forked workers; the worker's messages on every file are passed to the parent process through a pipe" << endl;
+    *streamPtr.get() << "# along with the statistics and printed in the order of the files; a failed file doesn't stop hipifying the rest of the files," << endl;
+    *streamPtr.get() << "# and the failure is returned after all the files are hipified" << endl;
+    *streamPtr.get() << "sub hipifyFilesInParallel {" << endl;
+    *streamPtr.get() << tab << "my @files = @_;" << endl;
+    *streamPtr.get() << tab << "my $select = IO::Select->new();" << endl;
+    *streamPtr.get() << tab << "my %buffers;" << endl;
+    *streamPtr.get() << tab << "my @pids;" << endl;
+    *streamPtr.get() << tab << "STDOUT->flush();" << endl;
+    *streamPtr.get() << tab << "STDERR->flush();" << endl;
+    *streamPtr.get() << tab << "for my $worker (0 .. $jobs - 1) {" << endl;
+    *streamPtr.get() << tab_2 << "pipe(my $reader, my $writer) or die \"error: could not create a pipe: $!\";" << endl;
+    *streamPtr.get() << tab_2 << "my $pid = fork();" << endl;
+    *streamPtr.get() << tab_2 << "die \"error: could not fork: $!\" unless defined $pid;" << endl;
+    *streamPtr.get() << tab_2 << "if (!$pid) {" << endl;
+    *streamPtr.get() << tab_3 << "close($reader);" << endl;
+    *streamPtr.get() << tab_3 << "binmode($writer);" << endl;
+    *streamPtr.get() << tab_3 << "my $status = 0;" << endl;
+    *streamPtr.get() << tab_3 << "for (my $i = $worker; $i < @files; $i += $jobs) {" << endl;
+    *streamPtr.get() << tab_4 << "my $messages = \"\";" << endl;
+    *streamPtr.get() << tab_4 << "close(STDERR);" << endl;
+    *streamPtr.get() << tab_4 << "open(STDERR, \">\", \\$messages);" << endl;
+    *streamPtr.get() << tab_4 << "$status = 1 unless eval { hipifyFile($files[$i]); 1 };" << endl;
+    *streamPtr.get() << tab_4 << "print STDERR $@ if $status;" << endl;
+    *streamPtr.get() << tab_4 << "close(STDERR);" << endl;
+    *streamPtr.get() << tab_4 << "print $writer \"O $i \" . length($messages) . \"\\n\" . $messages;" << endl;
+    *streamPtr.get() << tab_3 << "}" << endl;
+    *streamPtr.get() << tab_3 << "sendStats($writer);" << endl;
+    *streamPtr.get() << tab_3 << "close($writer);" << endl;
+    *streamPtr.get() << tab_3 << "exit($status);" << endl;
+    *streamPtr.get() << tab_2 << "}" << endl;
+    *streamPtr.get() << tab_2 << "close($writer);" << endl;
+    *streamPtr.get() << tab_2 << "$select->add($reader);" << endl;
+    *streamPtr.get() << tab_2 << "$buffers{$reader} = \"\";" << endl;
+    *streamPtr.get() << tab_2 << "push(@pids, $pid);" << endl;
+    *streamPtr.get() << tab << "}" << endl;
+    *streamPtr.get() << tab << "my @messages;" << endl;
+    *streamPtr.get() << tab << "my $next = 0;" << endl;
+    *streamPtr.get() << tab << "while ($select->count()) {" << endl;
+    *streamPtr.get() << tab_2 << "foreach my $reader ($select->can_read()) {" << endl;
+    *streamPtr.get() << tab_3 << "unless (sysread($reader, $buffers{$reader}, 65536, length($buffers{$reader}))) {" << endl;
+    *streamPtr.get() << tab_4 << "$select->remove($reader);" << endl;
+    *streamPtr.get() << tab_4 << "close($reader);" << endl;
+    *streamPtr.get() << tab_4 << "next;" << endl;
+    *streamPtr.get() << tab_3 << "}" << endl;
+    *streamPtr.get() << tab_3 << "while (1) {" << endl;
+    *streamPtr.get() << tab_4 << "if ($buffers{$reader} =~ /^O (\\d+) (\\d+)\\n/ and length($buffers{$reader}) >= $+[0] + $2) {" << endl;
+    *streamPtr.get() << tab_5 << "$messages[$1] = substr($buffers{$reader}, $+[0], $2);" << endl;
+    *streamPtr.get() << tab_5 << "substr($buffers{$reader}, 0, $+[0] + $2) = \"\";" << endl;
+    *streamPtr.get() << tab_4 << "} elsif ($buffers{$reader} =~ /^S ([^\\t]*)\\t([^\\t]*)\\t([^\\n]*)\\n/) {" << endl;
+    *streamPtr.get() << tab_5 << "receiveStats($1, $2, $3);" << endl;
+    *streamPtr.get() << tab_5 << "substr($buffers{$reader}, 0, $+[0]) = \"\";" << endl;
+    *streamPtr.get() << tab_4 << "} else {" << endl;
+    *streamPtr.get() << tab_5 << "last;" << endl;
+    *streamPtr.get() << tab_4 << "}" << endl;
+    *streamPtr.get() << tab_3 << "}" << endl;
+    *streamPtr.get() << tab_3 << "while (defined $messages[$next]) {" << endl;
+    *streamPtr.get() << tab_4 << "print STDERR $messages[$next];" << endl;
+    *streamPtr.get() << tab_4 << "$messages[$next++] = \"\";" << endl;
+    *streamPtr.get() << tab_3 << "}" << endl;
+    *streamPtr.get() << tab_2 << "}" << endl;
+    *streamPtr.get() << tab << "}" << endl;
+    *streamPtr.get() << tab << "# The messages, which are still not printed, e.g. of a crashed worker's files, are printed in the order of the files as well" << endl;
+    *streamPtr.get() << tab << "for (; $next < @messages; ++$next) {" << endl;
+    *streamPtr.get() << tab_2 << "print STDERR $messages[$next] if defined $messages[$next];" << endl;
+    *streamPtr.get() << tab << "}" << endl;
+    *streamPtr.get() << tab << "my $status = 0;" << endl;
+    *streamPtr.get() << tab << "foreach my $pid (@pids) {" << endl;
+    *streamPtr.get() << tab_2 << "waitpid($pid, 0);" << endl;
+    *streamPtr.get() << tab_2 << "$status = 1 if $?;" << endl;
+    *streamPtr.get() << tab << "}" << endl;
+    *streamPtr.get() << tab << "return $status;" << endl;
+    *streamPtr.get() << "}" << endl;
+  }
+
   bool generate(bool Generate) {
     if (!Generate) return true;
     string dstHipifyPerl = hipify_perl, dstHipifyPerlDir = OutputHipifyPerlDir;
@@ -717,14 +866,21 @@ namespace perl {
     *streamPtr.get() << "\"" << counterNames[NUM_CONV_TYPES - 1] << "\");" << endl;
     generateStatFunctions(streamPtr);
     generateSubstFunction(streamPtr);
-    generateExperimentalSubstitutions(streamPtr);
-    generateRocSubstitutions(streamPtr);
-    generateSimpleSubstitutions(streamPtr);
+    generateIncludeSubstitutions(streamPtr, sExperimentalSubstitutions, rs_Experimental);
+    generateIncludeSubstitutions(streamPtr, sRocSubstitutions, rs_Roc);
+    generateIncludeSubstitutions(streamPtr, sSimpleSubstitutions, rs_Simple);
+    Modules modules;
+    generateNameSubstitutions(streamPtr, modules);
     generateKernelLaunch(streamPtr);
     generateCubNamespace(streamPtr);
     generateHostFunctions(streamPtr);
     generateDeviceFunctions(streamPtr);
-    generateDeprecatedAndUnsupportedFunctions(streamPtr);
+    generateDeprecatedAndUnsupportedFunctions(streamPtr, modules);
+    if (GeneratePerlModules && !generateModules(streamPtr, modules, dstHipifyPerl)) {
+      streamPtr.reset();
+      if (!SaveTemps) sys::fs::remove(tmpFile);
+      return false;
+    }
     *streamPtr.get() << endl << "# Count of transforms in all files" << endl;
     *streamPtr.get() << my << "%tt;" << endl;
     *streamPtr.get() << "clearStats(\\%tt, \\@statNames);" << endl;
@@ -732,14 +888,15 @@ namespace perl {
     *streamPtr.get() << "$TlineCount = 0;" << endl;
     *streamPtr.get() << my << "%TwarningTags;" << endl;
     *streamPtr.get() << my << "$fileCount = @ARGV;" << endl;
+    if (!GeneratePerlModules) *streamPtr.get() << "%names = (%" << sSimpleNames << ", ($experimental ? %" << sExperimentalNames << " : ()), ($roc ? %" << sRocNames << " : ()));" << endl;
     *streamPtr.get() << "if ($help) {" << endl;
     *streamPtr.get() << tab << "print STDERR \"$USAGE\\n\";" << endl;
     *streamPtr.get() << "}" << endl;
     *streamPtr.get() << "if ($version) {" << endl;
     *streamPtr.get() << tab << "print STDERR \"HIP version " + sHIP_version + "\\n\";" << endl;
     *streamPtr.get() << "}" << endl;
-    *streamPtr.get() << while_ << "(@ARGV) {" << endl;
-    *streamPtr.get() << tab << "$fileName=shift (@ARGV);" << endl;
+    *streamPtr.get() << endl << sub << sHipifyFile << " {" << endl;
+    *streamPtr.get() << tab << "$fileName = shift();" << endl;
     *streamPtr.get() << tab << "my $direxclude = 0;" << endl;
     *streamPtr.get() << tab << "my $fileDir = dirname(Cwd::realpath($fileName));" << endl;
     *streamPtr.get() << tab << "if ($exclude_dirhash{$fileDir}) {" << endl;
@@ -784,6 +941,7 @@ namespace perl {
     *streamPtr.get() << tab_2 << "undef $/;" << endl;
     *streamPtr.get() << tab_2 << "# Read whole file at once, so we can match newlines" << endl;
     *streamPtr.get() << tab_2 << while_ << "(<INFILE>) {" << endl;
+    if (GeneratePerlModules) *streamPtr.get() << tab_3 << "loadModules();" << endl;
     *streamPtr.get() << tab_3 << "$countKeywords += m/__global__/;" << endl;
     *streamPtr.get() << tab_3 << "$countKeywords += m/__shared__/;" << endl;
     *streamPtr.get() << tab_3 << unless_ << "($quiet_warnings) {" << endl;
@@ -820,6 +978,7 @@ namespace perl {
     *streamPtr.get() << tab_4 << sExperimentalSubstitutions << "();" << endl;
     *streamPtr.get() << tab_3 << "}" << endl;
     *streamPtr.get() << tab_3 << sSimpleSubstitutions << "();" << endl;
+    *streamPtr.get() << tab_3 << sNameSubstitutions << "();" << endl;
     *streamPtr.get() << tab_3 << "if (!$cuda_kernel_execution_syntax || $hip_kernel_execution_syntax) {" << endl;
     *streamPtr.get() << tab_4 << sTransformKernelLaunch << "();" << endl;
     *streamPtr.get() << tab_3 << "}" << endl;
@@ -871,11 +1030,20 @@ namespace perl {
     *streamPtr.get() << tab_3 << "$TwarningTags{$key} += $warningTags{$key};" << endl_tab_2 << "}";
     *streamPtr.get() << endl_tab << "}   # Unless filtered directory or file" << endl;
     *streamPtr.get() << "}" << endl;
+    generateParallelProcessing(streamPtr);
+    *streamPtr.get() << endl << "my $parallelStatus = 0;" << endl;
+    *streamPtr.get() << "if ($jobs > 1 and $fileCount > 1 and ($inplace or $no_output)) {" << endl;
+    *streamPtr.get() << tab << "$parallelStatus = " << sHipifyFilesInParallel << "(@ARGV);" << endl;
+    *streamPtr.get() << "} else {" << endl;
+    *streamPtr.get() << tab << while_ << "(@ARGV) {" << endl;
+    *streamPtr.get() << tab_2 << sHipifyFile << "(shift(@ARGV));" << endl_tab << "}" << endl;
+    *streamPtr.get() << "}" << endl;
     *streamPtr.get() << "# Print total stats for all files processed" << endl;
     *streamPtr.get() << "if ($print_stats and ($fileCount > 1)) {" << endl;
     *streamPtr.get() << tab << "printStats(\\%tt, $Twarnings, $TlineCount, \"GLOBAL\", 1);" << endl;
     *streamPtr.get() << tab << print << "\"\\n\";" << endl;
     *streamPtr.get() << "}" << endl;
+    *streamPtr.get() << "exit(1) if $parallelStatus;" << endl;
     streamPtr.get()->flush();
     bool ret = true;
     EC = sys::fs::copy_file(tmpFile, dstHipifyPerl);
@@ -20,84 +20,152 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 
+#include <fstream>
+#include <map>
 #include <sstream>
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Support/Path.h"
 #include "CUDA2HIP.h"
 #include "CUDA2HIP_Scripting.h"
-#include "ArgParse.h"
+#include "Options.h"
 #include "StringUtils.h"
-#include "LLVMCompat.h"
+#include "LLVMCompatSupport.h"
 #include "Statistics.h"
 
 using namespace llvm;
 
 namespace python {
 
-  bool generate(bool Generate) {
-    if (!Generate) {
-      return true;
+  const std::string sPythonMap = "cuda_to_hip_mappings.py";
+  const std::string sPythonPrebuiltMap = "cuda_to_hip_mappings_prebuilt.py";
+
+  struct Entry {
+    std::string cudaName;
+    std::string hipName;
+    ConvTypes type;
+    ApiTypes apiType;
+    bool bUnsupported;
+  };
+
+  void addEntry(std::vector<Entry> &entries, const std::pair<const StringRef, hipCounter> &ma) {
+    StringRef repName = Statistics::isToRoc(ma.second) ? ma.second.rocName : ma.second.hipName;
+    entries.push_back({ma.first.str(), repName.str(), ma.second.type, ma.second.apiType, Statistics::isUnsupported(ma.second)});
+  }
+
+  // Get all the entries of the Python map in the order of conversion types.
+  std::vector<Entry> getEntries() {
+    std::vector<Entry> entries;
+    for (int i = 0; i < NUM_CONV_TYPES; ++i) {
+      if (i == CONV_INCLUDE_CUDA_MAIN_H || i == CONV_INCLUDE) {
+        for (auto &ma : CUDA_INCLUDE_MAP)
+          if (i == ma.second.type) addEntry(entries, ma);
+      } else {
+        for (auto &ma : CUDA_RENAMES_MAP())
+          if (i == ma.second.type) addEntry(entries, ma);
+      }
     }
-    std::string dstPythonMap = "cuda_to_hip_mappings.py", dstPythonMapDir = OutputPythonMapDir;
-    std::error_code EC;
-    if (!dstPythonMapDir.empty()) {
-      std::string sOutputPythonMapDirAbsPath = getAbsoluteDirectoryPath(OutputPythonMapDir, EC, "output hipify-python map");
-      if (EC) {
-        return false;
+    return entries;
+  }
+
+  void generateMap(std::ostream &os, const std::vector<Entry> &entries) {
+    os << "import collections\n\n";
+    os << "from pyHIPIFY.constants import *\n\n";
+    os << "CUDA_RENAMES_MAP = collections.OrderedDict([\n";
+    const std::string sHIP_UNS = ", HIP_UNSUPPORTED";
+    for (const auto &e : entries)
+      os << "    (\"" << e.cudaName << "\", (\"" << e.hipName << "\", " << counterTypes[e.type] << ", " << apiTypes[e.apiType] << (e.bUnsupported ? sHIP_UNS : "") << ")),\n";
+    os << "])\n\n";
+    os << "CUDA_TO_HIP_MAPPINGS = [CUDA_RENAMES_MAP, C10_MAPPINGS, PYTORCH_SPECIFIC_MAPPINGS]\n";
+  }
+
+  void generateTuple(std::ostream &os, const std::string &name, const std::vector<std::string> &items) {
+    os << name << " = (\n";
+    for (const auto &item : items)
+      os << "    \"" << item << "\",\n";
+    os << ")\n\n";
+  }
+
+  /**
+    * Generate the prebuilt counterpart of CUDA_RENAMES_MAP, which doesn't need building the tries and regexes
+    * over all the keys on every run: the trie regexes (in the form of StringUtils' buildTrieRegex) and the flat
+    * tuples of the keys and replacements, which are stored as constants in .pyc and loaded by marshal at once.
+    */
+  void generatePrebuiltMap(std::ostream &os, const std::vector<Entry> &entries) {
+    // As in the OrderedDict, the last entry with the same key wins; Caffe2-only entries go last, as they are
+    // excluded from the PyTorch replacements.
+    std::map<std::string, std::pair<std::string, bool>> renames;
+    for (const auto &e : entries)
+      renames[e.cudaName] = std::make_pair(e.hipName, e.apiType == API_CAFFE2);
+    std::vector<std::string> sources, targets, pytorchSources;
+    for (int bCaffe2 = 0; bCaffe2 < 2; ++bCaffe2) {
+      for (const auto &r : renames) {
+        if (r.second.second != bool(bCaffe2)) continue;
+        sources.push_back(r.first);
+        targets.push_back(r.second.first);
+        if (!bCaffe2) pytorchSources.push_back(r.first);
       }
-      dstPythonMap = sOutputPythonMapDirAbsPath + "/" + dstPythonMap;
     }
+    os << "# Prebuilt CUDA_RENAMES_MAP of " << sPythonMap << ", generated by hipify-clang.\n";
+    os << "#\n";
+    os << "# CUDA_RENAMES_PYTORCH_PATTERN and CUDA_RENAMES_CAFFE2_PATTERN are the regexes, matching any of the keys\n";
+    os << "# of the map without and with the Caffe2 API ones correspondingly, in the form of a prefix trie, which is\n";
+    os << "# optimal for alternation. CUDA_RENAMES_SOURCES and CUDA_RENAMES_TARGETS are the flat tuples of the keys\n";
+    os << "# and their replacements: the first CUDA_RENAMES_PYTORCH_COUNT ones are not of the Caffe2 API, both parts are sorted:\n";
+    os << "#\n";
+    os << "#   PYTORCH_MAP = dict(zip(CUDA_RENAMES_SOURCES[:CUDA_RENAMES_PYTORCH_COUNT], CUDA_RENAMES_TARGETS))\n";
+    os << "#   RE_PYTORCH_PREPROCESSOR = re.compile(r'(?<=\\W)({0})(?=\\W)'.format(CUDA_RENAMES_PYTORCH_PATTERN))\n\n";
+    os << "CUDA_RENAMES_PYTORCH_COUNT = " << pytorchSources.size() << "\n\n";
+    os << "CUDA_RENAMES_PYTORCH_PATTERN = r\"" << buildTrieRegex(pytorchSources) << "\"\n\n";
+    os << "CUDA_RENAMES_CAFFE2_PATTERN = r\"" << buildTrieRegex(sources) << "\"\n\n";
+    generateTuple(os, "CUDA_RENAMES_SOURCES", sources);
+    generateTuple(os, "CUDA_RENAMES_TARGETS", targets);
+  }
+
+  bool write(const std::string &dstFile, const std::string &content) {
     SmallString<128> tmpFile;
     StringRef ext = "hipify-tmp";
-    EC = sys::fs::createTemporaryFile(dstPythonMap, ext, tmpFile);
+    std::error_code EC = sys::fs::createTemporaryFile(dstFile, ext, tmpFile);
     if (EC) {
       llvm::errs() << "\n" << sHipify << sError << EC.message() << ": " << tmpFile << "\n";
       return false;
     }
-    std::unique_ptr<std::ostream> pythonStreamPtr = std::unique_ptr<std::ostream>(new std::ofstream(tmpFile.c_str(), std::ios_base::trunc));
-    *pythonStreamPtr.get() << "import collections\n\n";
-    *pythonStreamPtr.get() << "from pyHIPIFY.constants import *\n\n";
-    *pythonStreamPtr.get() << "CUDA_RENAMES_MAP = collections.OrderedDict([\n";
-    const std::string sHIP_UNS = ", HIP_UNSUPPORTED";
-    for (int i = 0; i < NUM_CONV_TYPES; ++i) {
-      if (i == CONV_INCLUDE_CUDA_MAIN_H || i == CONV_INCLUDE) {
-        for (auto &ma : CUDA_INCLUDE_MAP) {
-          if (i == ma.second.type) {
-            std::string sUnsupported;
-            if (Statistics::isUnsupported(ma.second)) {
-              sUnsupported = sHIP_UNS;
-            }
-            StringRef repName = Statistics::isToRoc(ma.second) ? ma.second.rocName : ma.second.hipName;
-            *pythonStreamPtr.get() << "    (\"" << ma.first.str() << "\", (\"" << repName.str() << "\", " << counterTypes[i] << ", " << apiTypes[ma.second.apiType] << sUnsupported << ")),\n";
-          }
-        }
-      }
-      else {
-        for (auto &ma : CUDA_RENAMES_MAP()) {
-          if (i == ma.second.type) {
-            std::string sUnsupported;
-            if (Statistics::isUnsupported(ma.second)) {
-              sUnsupported = sHIP_UNS;
-            }
-            StringRef repName = Statistics::isToRoc(ma.second) ? ma.second.rocName : ma.second.hipName;
-            *pythonStreamPtr.get() << "    (\"" << ma.first.str() << "\", (\"" << repName.str() << "\", " << counterTypes[i] << ", " << apiTypes[ma.second.apiType] << sUnsupported << ")),\n";
-          }
-        }
-      }
+    {
+      std::ofstream tmpStream(tmpFile.c_str(), std::ios_base::trunc);
+      tmpStream << content;
     }
-    *pythonStreamPtr.get() << "])\n\n";
-    *pythonStreamPtr.get() << "CUDA_TO_HIP_MAPPINGS = [CUDA_RENAMES_MAP, C10_MAPPINGS, PYTORCH_SPECIFIC_MAPPINGS]\n";
-    pythonStreamPtr.get()->flush();
     bool ret = true;
-    EC = sys::fs::copy_file(tmpFile, dstPythonMap);
+    EC = sys::fs::copy_file(tmpFile, dstFile);
     if (EC) {
-      llvm::errs() << "\n" << sHipify << sError << EC.message() << ": while copying " << tmpFile << " to " << dstPythonMap << "\n";
+      llvm::errs() << "\n" << sHipify << sError << EC.message() << ": while copying " << tmpFile << " to " << dstFile << "\n";
       ret = false;
     }
     if (!SaveTemps) {
       sys::fs::remove(tmpFile);
     }
-    return true;
+    return ret;
+  }
+
+  bool generate(bool Generate) {
+    if (!Generate) {
+      return true;
+    }
+    std::string dstPythonMap = sPythonMap, dstPythonPrebuiltMap = sPythonPrebuiltMap, dstPythonMapDir = OutputPythonMapDir;
+    std::error_code EC;
+    if (!dstPythonMapDir.empty()) {
+      std::string sOutputPythonMapDirAbsPath = getAbsoluteDirectoryPath(OutputPythonMapDir, EC, "output hipify-python map");
+      if (EC) {
+        return false;
+      }
+      dstPythonMap = sOutputPythonMapDirAbsPath + "/" + dstPythonMap;
+      dstPythonPrebuiltMap = sOutputPythonMapDirAbsPath + "/" + dstPythonPrebuiltMap;
+    }
+    std::vector<Entry> entries = getEntries();
+    std::ostringstream map, prebuiltMap;
+    generateMap(map, entries);
+    generatePrebuiltMap(prebuiltMap, entries);
+    bool bMap = write(dstPythonMap, map.str());
+    bool bPrebuiltMap = write(dstPythonPrebuiltMap, prebuiltMap.str());
+    return bMap && bPrebuiltMap;
   }
 }
@@ -0,0 +1,252 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "CUDA2HIP.h"
+#include "CUDA2HIP_Scripting.h"
+#include "Options.h"
+
+namespace hipify {
+
+  std::string sHIP_SYMBOL = "HIP_SYMBOL";
+  std::string s_reinterpret_cast = "reinterpret_cast<const void*>";
+  std::string s_int32_t = "int32_t";
+  std::string s_int64_t = "int64_t";
+  // CUDA identifiers, used in matchers
+  const std::string sCudaMemcpyToSymbol = "cudaMemcpyToSymbol";
+  const std::string sCudaMemcpyToSymbolAsync = "cudaMemcpyToSymbolAsync";
+  const std::string sCudaGetSymbolSize = "cudaGetSymbolSize";
+  const std::string sCudaGetSymbolAddress = "cudaGetSymbolAddress";
+  const std::string sCudaMemcpyFromSymbol = "cudaMemcpyFromSymbol";
+  const std::string sCudaMemcpyFromSymbolAsync = "cudaMemcpyFromSymbolAsync";
+  const std::string sCudaGraphAddMemcpyNodeToSymbol = "cudaGraphAddMemcpyNodeToSymbol";
+  const std::string sCudaGraphAddMemcpyNodeFromSymbol = "cudaGraphAddMemcpyNodeFromSymbol";
+  const std::string sCudaGraphMemcpyNodeSetParamsToSymbol = "cudaGraphMemcpyNodeSetParamsToSymbol";
+  const std::string sCudaGraphMemcpyNodeSetParamsFromSymbol = "cudaGraphMemcpyNodeSetParamsFromSymbol";
+  const std::string sCudaGraphExecMemcpyNodeSetParamsToSymbol = "cudaGraphExecMemcpyNodeSetParamsToSymbol";
+  const std::string sCudaGraphExecMemcpyNodeSetParamsFromSymbol = "cudaGraphExecMemcpyNodeSetParamsFromSymbol";
+  const std::string sCuOccupancyMaxPotentialBlockSize = "cuOccupancyMaxPotentialBlockSize";
+  const std::string sCuOccupancyMaxPotentialBlockSizeWithFlags = "cuOccupancyMaxPotentialBlockSizeWithFlags";
+  const std::string sCudaGetTextureReference = "cudaGetTextureReference";
+
+  const std::string sCudaDevice = "cudaDevice";
+  const std::string sCudaDeviceId = "cudaDeviceId";
+  const std::string sCudaDevices = "cudaDevices";
+  const std::string sCudaDevice_t = "cudaDevice_t";
+  const std::string sCudaIDs = "cudaIDs";
+  const std::string sCudaGridDim = "cudaGridDim";
+  const std::string sCudaDimGrid = "cudaDimGrid";
+  const std::string sCudaDimBlock = "cudaDimBlock";
+  const std::string sCudaGradInput = "cudaGradInput";
+  const std::string sCudaGradOutput = "cudaGradOutput";
+  const std::string sCudaInput = "cudaInput";
+  const std::string sCudaOutput = "cudaOutput";
+  const std::string sCudaOprod = "cudaOprod";
+  const std::string sCudaOprod_ex = "cudaOprod_ex";
+  const std::string sCudaLongLinkOprod = "cudaLongLinkOprod";
+  const std::string sCudaLongLinkOprod_ex = "cudaLongLinkOprod_ex";
+  const std::string sCudaQuark = "cudaQuark";
+  const std::string sCudaIndices = "cudaIndices";
+  const std::string sCudaGaugeField = "cudaGaugeField";
+  const std::string sCudaQdpGauge = "cudaQdpGauge";
+  const std::string sCudaCpsGauge = "cudaCpsGauge";
+  const std::string sCudaMom = "cudaMom";
+  const std::string sCudaGauge = "cudaGauge";
+  const std::string sCudaGauge_ex = "cudaGauge_ex";
+  const std::string sCudaInGauge = "cudaInGauge";
+  const std::string sCudaInGaugeEx = "cudaInGaugeEx";
+  const std::string sCudaOutGauge = "cudaOutGauge";
+  const std::string sCudaGaugeTemp = "cudaGaugeTemp";
+  const std::string sCudaSpinorOut = "cudaSpinorOut";
+  const std::string sCudaSpinor = "cudaSpinor";
+  const std::string sCudaColorSpinorField = "cudaColorSpinorField";
+  const std::string sCudaInLink = "cudaInLink";
+  const std::string sCudaInLinkEx = "cudaInLinkEx";
+  const std::string sCudaSiteLink = "cudaSiteLink";
+  const std::string sCudaFatLink = "cudaFatLink";
+  const std::string sCudaLongLink = "cudaLongLink";
+  const std::string sCudaUnitarizedLink = "cudaUnitarizedLink";
+  const std::string sCudaULink = "cudaULink";
+  const std::string sCudaStaple = "cudaStaple";
+  const std::string sCudaCloverField = "cudaCloverField";
+  const std::string sCudaParam = "cudaParam";
+  const std::string sCudaForce = "cudaForce";
+  const std::string sCudaInForce = "cudaInForce";
+  const std::string sCudaForce_ex = "cudaForce_ex";
+  const std::string sCudaOutForce = "cudaOutForce";
+  const std::string sCudaResult = "cudaResult";
+  const std::string sCudaMemcpys ="cudaMemcpys";
+  const std::string sCudaRitzVectors = "cudaRitzVectors";
+  const std::string sCudaEigValueSet = "cudaEigValueSet";
+  const std::string sCudaEigVecSet = "cudaEigVecSet";
+  
+  const std::set<std::string> Whitelist{
+    {sCudaDevice}, {sCudaDevice_t}, {sCudaIDs}, {sCudaGridDim}, {sCudaDimGrid}, {sCudaDimBlock}, {sCudaDeviceId}, {sCudaDevices},
+    {sCudaGradInput}, {sCudaGradOutput}, {sCudaInput}, {sCudaOutput}, {sCudaIndices}, {sCudaMom}, {sCudaGauge},
+    {sCudaInGauge}, {sCudaSpinorOut}, {sCudaSpinor}, {sCudaColorSpinorField}, {sCudaSiteLink}, {sCudaFatLink}, {sCudaStaple}, {sCudaCloverField}, {sCudaParam}, {sCudaOutForce}, {sCudaGaugeTemp}, {sCudaResult}, {sCudaForce}, {sCudaInForce}, {sCudaForce_ex}, {sCudaOprod_ex}, {sCudaOutGauge}, {sCudaULink}, {sCudaOprod}, {sCudaGauge_ex}, {sCudaQuark}, {sCudaLongLinkOprod_ex}, {sCudaInGaugeEx}, {sCudaLongLink}, {sCudaUnitarizedLink}, {sCudaQdpGauge}, {sCudaCpsGauge}, {sCudaInLink}, {sCudaInLinkEx}, {sCudaGaugeField}, {sCudaMemcpys}, {sCudaRitzVectors}, {sCudaEigValueSet}, {sCudaLongLinkOprod}, {sCudaEigVecSet}
+  };
+
+  // Deprecated and removed CUDA identifiers with the CUDA versions, experimental ones with the HIP versions.
+  void getVersionedNames(VersionedNames &deprecated, VersionedNames &removed, VersionedNames &experimental) {
+    for (auto ma = CUDA_RENAMES_MAP().rbegin(); ma != CUDA_RENAMES_MAP().rend(); ++ma) {
+      bool bDeprecated = Statistics::isCudaDeprecated(ma->second);
+      bool bRemoved = Statistics::isCudaRemoved(ma->second);
+      bool bExperimental = Statistics::isHipExperimental(ma->second);
+      if (!bDeprecated && !bRemoved && !bExperimental) continue;
+      const hipRecord *record = findRecord(ma->first);
+      if (!record) continue;
+      if (bDeprecated && record->cudaVer.deprecated != CUDA_0) deprecated.push_back({ma->first.str(), Statistics::getCudaVersion(record->cudaVer.deprecated)});
+      if (bRemoved && record->cudaVer.removed != CUDA_0) removed.push_back({ma->first.str(), Statistics::getCudaVersion(record->cudaVer.removed)});
+      if (bExperimental && record->hipVer.experimental != HIP_0) experimental.push_back({ma->first.str(), Statistics::getHipVersion(record->hipVer.experimental)});
+    }
+  }
+
+  void getUnsupportedNames(std::vector<std::string> &unsupported, std::vector<std::string> &hipUnsupported, std::vector<std::string> &rocUnsupported) {
+    bool bTranslateToRoc = TranslateToRoc;
+    for (auto ma = CUDA_RENAMES_MAP().rbegin(); ma != CUDA_RENAMES_MAP().rend(); ++ma) {
+      TranslateToRoc = false;
+      if (Statistics::isUnsupported(ma->second)) {
+        if (ma->second.apiType == API_BLAS) hipUnsupported.push_back(ma->first.str());
+        else unsupported.push_back(ma->first.str());
+      }
+      TranslateToRoc = true;
+      if (Statistics::isUnsupported(ma->second) && ma->second.apiType == API_BLAS) rocUnsupported.push_back(ma->first.str());
+    }
+    TranslateToRoc = bTranslateToRoc;
+  }
+
+  void getDeviceFunctionNames(std::vector<std::string> &supported, std::vector<std::string> &unsupported) {
+    for (auto ma = CUDA_DEVICE_FUNCTION_MAP.rbegin(); ma != CUDA_DEVICE_FUNCTION_MAP.rend(); ++ma)
+      (Statistics::isUnsupported(ma->second) ? unsupported : supported).push_back(ma->first.str());
+  }
+
+  bool isInRenameSet(const hipCounter &c, RenameSet set) {
+    switch (set) {
+      case rs_Simple: return !Statistics::isUnsupported(c) && !Statistics::isHipExperimental(c);
+      case rs_Experimental: return Statistics::isHipExperimental(c);
+      case rs_Roc: return c.apiType == API_BLAS && !Statistics::isUnsupported(c) && !c.rocName.empty();
+      default: return false;
+    }
+  }
+
+  std::vector<Rename> getIncludeRenames(RenameSet set) {
+    std::vector<Rename> renames;
+    bool bTranslateToRoc = TranslateToRoc;
+    TranslateToRoc = false;
+    for (int i = 0; i < NUM_CONV_TYPES; ++i) {
+      if (i != CONV_INCLUDE_CUDA_MAIN_H && i != CONV_INCLUDE_CUDA_MAIN_V2_H && i != CONV_INCLUDE) continue;
+      for (auto &ma : CUDA_INCLUDE_MAP) {
+        if (i != ma.second.type) continue;
+        if (set == rs_Roc) {
+          if (ma.first != "cublas.h" && ma.first != "cublas_v2.h") continue;
+          renames.push_back({ma.first.str(), ma.second.rocName.str(), ma.second.type});
+          continue;
+        }
+        if (isInRenameSet(ma.second, set)) renames.push_back({ma.first.str(), ma.second.hipName.str(), ma.second.type});
+      }
+    }
+    TranslateToRoc = bTranslateToRoc;
+    return renames;
+  }
+
+  std::vector<Rename> getNameRenames(RenameSet set) {
+    std::vector<Rename> renames;
+    bool bTranslateToRoc = TranslateToRoc;
+    // The names are taken regardless of the -roc option: the ROC ones as if it is on, the others as if it is off
+    TranslateToRoc = set == rs_Roc;
+    for (auto &ma : CUDA_RENAMES_MAP()) {
+      if (!isInRenameSet(ma.second, set)) continue;
+      renames.push_back({ma.first.str(), (set == rs_Roc ? ma.second.rocName : ma.second.hipName).str(), ma.second.type});
+    }
+    TranslateToRoc = bTranslateToRoc;
+    return renames;
+  }
+
+  bool getNameRename(llvm::StringRef cudaName, const hipCounter &counter, bool bRoc, bool bExperimental, Rename &rename) {
+    bool bTranslateToRoc = TranslateToRoc;
+    bool bFound = false;
+    // The later sets override the earlier ones, so they are checked first
+    TranslateToRoc = true;
+    if (bRoc && isInRenameSet(counter, rs_Roc)) {
+      rename = {cudaName.str(), counter.rocName.str(), counter.type};
+      bFound = true;
+    }
+    TranslateToRoc = false;
+    if (!bFound && ((bExperimental && isInRenameSet(counter, rs_Experimental)) || isInRenameSet(counter, rs_Simple))) {
+      rename = {cudaName.str(), counter.hipName.str(), counter.type};
+      bFound = true;
+    }
+    TranslateToRoc = bTranslateToRoc;
+    return bFound;
+  }
+
+  std::vector<ArgRewrite> getArgRewrites() {
+    // The order of the rewrites matters: a function might have more than one argument to rewrite.
+    std::vector<ArgRewrite> rewrites{
+      {0, e_HIP_SYMBOL, {}}, {1, e_HIP_SYMBOL, {}}, {0, e_reinterpret_cast, {}}, {1, e_reinterpret_cast, {}}, {2, e_HIP_SYMBOL, {}},
+      {3, e_remove_argument, {}}, {3, e_HIP_SYMBOL, {}}, {4, e_HIP_SYMBOL, {}}, {5, e_HIP_SYMBOL, {}},
+    };
+    for (auto &r : rewrites) {
+      for (auto &f : FuncArgCasts) {
+        const auto found = f.second.find(r.argNum);
+        if (found == f.second.end() || found->second.castType != r.castType) continue;
+        auto func = CUDA_RUNTIME_FUNCTION_MAP.find(f.first);
+        if (func == CUDA_RUNTIME_FUNCTION_MAP.end()) {
+          func = CUDA_DRIVER_FUNCTION_MAP.find(f.first);
+          if (func == CUDA_DRIVER_FUNCTION_MAP.end()) continue;
+        }
+        r.funcs.push_back(func->second.hipName.str());
+      }
+    }
+    return rewrites;
+  }
+}
+
+using namespace hipify;
+
+std::string getCastType(hipify::CastTypes c) {
+  switch (c) {
+    case e_HIP_SYMBOL: return sHIP_SYMBOL;
+    case e_reinterpret_cast: return s_reinterpret_cast;
+    case e_int32_t: return s_int32_t;
+    case e_int64_t: return s_int64_t;
+    case e_remove_argument: return "";
+    default: return "";
+  }
+}
+
+std::map<std::string, ArgCastMap> FuncArgCasts {
+  {sCudaMemcpyToSymbol, {{0, {e_HIP_SYMBOL, cw_None}}}},
+  {sCudaMemcpyToSymbolAsync, {{0, {e_HIP_SYMBOL, cw_None}}}},
+  {sCudaGetSymbolSize, {{1, {e_HIP_SYMBOL, cw_None}}}},
+  {sCudaGetSymbolAddress, {{1, {e_HIP_SYMBOL, cw_None}}}},
+  {sCudaMemcpyFromSymbol, {{1, {e_HIP_SYMBOL, cw_None}}}},
+  {sCudaMemcpyFromSymbolAsync, {{1, {e_HIP_SYMBOL, cw_None}}}},
+  {sCudaGraphAddMemcpyNodeToSymbol, {{4, {e_HIP_SYMBOL, cw_None}}}},
+  {sCudaGraphAddMemcpyNodeFromSymbol, {{5, {e_HIP_SYMBOL, cw_None}}}},
+  {sCudaGraphMemcpyNodeSetParamsToSymbol, {{1, {e_HIP_SYMBOL, cw_None}}}},
+  {sCudaGraphMemcpyNodeSetParamsFromSymbol, {{2, {e_HIP_SYMBOL, cw_None}}}},
+  {sCudaGraphExecMemcpyNodeSetParamsToSymbol, {{2, {e_HIP_SYMBOL, cw_None}}}},
+  {sCudaGraphExecMemcpyNodeSetParamsFromSymbol, {{3, {e_HIP_SYMBOL, cw_None}}}},
+  {sCudaGetTextureReference, {{1, {e_HIP_SYMBOL, cw_None}}}},
+  {sCuOccupancyMaxPotentialBlockSize, {{3, {e_remove_argument, cw_DataLoss}}}},
+  {sCuOccupancyMaxPotentialBlockSizeWithFlags, {{3, {e_remove_argument, cw_DataLoss}}}},
+};
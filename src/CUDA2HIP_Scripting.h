@@ -22,6 +22,12 @@ THE SOFTWARE.
 
 #pragma once
 
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "Statistics.h"
+
 namespace hipify {
 
   enum CastTypes {
@@ -43,6 +49,74 @@ namespace hipify {
   };
 
   typedef std::map<unsigned, CastInfo> ArgCastMap;
+
+  // CUDA identifiers with the arguments to cast
+  extern const std::string sCudaMemcpyToSymbol;
+  extern const std::string sCudaMemcpyToSymbolAsync;
+  extern const std::string sCudaGetSymbolSize;
+  extern const std::string sCudaGetSymbolAddress;
+  extern const std::string sCudaMemcpyFromSymbol;
+  extern const std::string sCudaMemcpyFromSymbolAsync;
+  extern const std::string sCudaGraphAddMemcpyNodeToSymbol;
+  extern const std::string sCudaGraphAddMemcpyNodeFromSymbol;
+  extern const std::string sCudaGraphMemcpyNodeSetParamsToSymbol;
+  extern const std::string sCudaGraphMemcpyNodeSetParamsFromSymbol;
+  extern const std::string sCudaGraphExecMemcpyNodeSetParamsToSymbol;
+  extern const std::string sCudaGraphExecMemcpyNodeSetParamsFromSymbol;
+  extern const std::string sCuOccupancyMaxPotentialBlockSize;
+  extern const std::string sCuOccupancyMaxPotentialBlockSizeWithFlags;
+  extern const std::string sCudaGetTextureReference;
+
+  // Whitelist of cuda[A-Z] identifiers, which are commonly used in CUDA sources but don't map to any CUDA API
+  extern const std::set<std::string> Whitelist;
+
+  // The data below is shared by the scripting generators and hipify-fast, so that all of them hipify in the same way.
+
+  typedef std::vector<std::pair<std::string, std::string>> VersionedNames;
+
+  // Deprecated and removed CUDA identifiers with the CUDA versions, experimental ones with the HIP versions.
+  void getVersionedNames(VersionedNames &deprecated, VersionedNames &removed, VersionedNames &experimental);
+
+  // Unsupported CUDA identifiers: the BLAS ones go separately, as unsupported by hipBLAS or by rocBLAS.
+  void getUnsupportedNames(std::vector<std::string> &unsupported, std::vector<std::string> &hipUnsupported, std::vector<std::string> &rocUnsupported);
+
+  // Supported and unsupported CUDA device functions.
+  void getDeviceFunctionNames(std::vector<std::string> &supported, std::vector<std::string> &unsupported);
+
+  enum RenameSet {
+    // Supported and not experimental
+    rs_Simple,
+    // Experimentally supported by HIP
+    rs_Experimental,
+    // Supported by rocBLAS; of the includes only cublas.h and cublas_v2.h
+    rs_Roc,
+  };
+
+  struct Rename {
+    std::string cudaName;
+    std::string hipName;
+    ConvTypes type;
+  };
+
+  // CUDA includes of the set in the order of their substitution.
+  std::vector<Rename> getIncludeRenames(RenameSet set);
+
+  // CUDA identifiers of the set.
+  std::vector<Rename> getNameRenames(RenameSet set);
+
+  // The rename of the CUDA identifier by the counter found for it, as of the sets taken by hipify-fast with the -roc and
+  // -experimental options; false if the identifier is in none of them.
+  bool getNameRename(llvm::StringRef cudaName, const hipCounter &counter, bool bRoc, bool bExperimental, Rename &rename);
+
+  struct ArgRewrite {
+    unsigned argNum;
+    CastTypes castType;
+    // HIP functions, which the argument is rewritten of
+    std::vector<std::string> funcs;
+  };
+
+  // HIP functions' argument rewrites in the order of their application.
+  std::vector<ArgRewrite> getArgRewrites();
 }
 
 extern std::string getCastType(hipify::CastTypes c);
@@ -31,8 +31,8 @@ THE SOFTWARE.
 #include "clang/Lex/HeaderSearch.h"
 #include "LLVMCompat.h"
 #include "CUDA2HIP.h"
+#include "MappingDB.h"
 #include "StringUtils.h"
-#include "ArgParse.h"
 
 using namespace hipify;
 
@@ -41,32 +41,12 @@ const std::string sROC = "ROC";
 const std::string sCub = "cub";
 const std::string sHipcub = "hipcub";
 const std::string sHIP_KERNEL_NAME = "HIP_KERNEL_NAME";
-std::string sHIP_SYMBOL = "HIP_SYMBOL";
-std::string s_reinterpret_cast = "reinterpret_cast<const void*>";
-std::string s_int32_t = "int32_t";
-std::string s_int64_t = "int64_t";
 const std::string sHipLaunchKernelGGL = "hipLaunchKernelGGL";
 const std::string sDim3 = "dim3(";
 const std::string s_hiprand_kernel_h = "hiprand_kernel.h";
 const std::string s_hiprand_h = "hiprand.h";
 const std::string sOnce = "once";
 const std::string s_string_literal = "[string literal]";
-// CUDA identifiers, used in matchers
-const std::string sCudaMemcpyToSymbol = "cudaMemcpyToSymbol";
-const std::string sCudaMemcpyToSymbolAsync = "cudaMemcpyToSymbolAsync";
-const std::string sCudaGetSymbolSize = "cudaGetSymbolSize";
-const std::string sCudaGetSymbolAddress = "cudaGetSymbolAddress";
-const std::string sCudaMemcpyFromSymbol = "cudaMemcpyFromSymbol";
-const std::string sCudaMemcpyFromSymbolAsync = "cudaMemcpyFromSymbolAsync";
-const std::string sCudaGraphAddMemcpyNodeToSymbol = "cudaGraphAddMemcpyNodeToSymbol";
-const std::string sCudaGraphAddMemcpyNodeFromSymbol = "cudaGraphAddMemcpyNodeFromSymbol";
-const std::string sCudaGraphMemcpyNodeSetParamsToSymbol = "cudaGraphMemcpyNodeSetParamsToSymbol";
-const std::string sCudaGraphMemcpyNodeSetParamsFromSymbol = "cudaGraphMemcpyNodeSetParamsFromSymbol";
-const std::string sCudaGraphExecMemcpyNodeSetParamsToSymbol = "cudaGraphExecMemcpyNodeSetParamsToSymbol";
-const std::string sCudaGraphExecMemcpyNodeSetParamsFromSymbol = "cudaGraphExecMemcpyNodeSetParamsFromSymbol";
-const std::string sCuOccupancyMaxPotentialBlockSize = "cuOccupancyMaxPotentialBlockSize";
-const std::string sCuOccupancyMaxPotentialBlockSizeWithFlags = "cuOccupancyMaxPotentialBlockSizeWithFlags";
-const std::string sCudaGetTextureReference = "cudaGetTextureReference";
 // Matchers' names
 const StringRef sCudaLaunchKernel = "cudaLaunchKernel";
 const StringRef sCudaHostFuncCall = "cudaHostFuncCall";
@@ -75,45 +55,19 @@ const StringRef sCubNamespacePrefix = "cubNamespacePrefix";
 const StringRef sCubFunctionTemplateDecl = "cubFunctionTemplateDecl";
 const StringRef sCubUsingNamespaceDecl = "cubUsingNamespaceDecl";
 
-std::string getCastType(hipify::CastTypes c) {
-  switch (c) {
-    case e_HIP_SYMBOL: return sHIP_SYMBOL;
-    case e_reinterpret_cast: return s_reinterpret_cast;
-    case e_int32_t: return s_int32_t;
-    case e_int64_t: return s_int64_t;
-    case e_remove_argument: return "";
-    default: return "";
-  }
-}
-
-std::map<std::string, ArgCastMap> FuncArgCasts {
-  {sCudaMemcpyToSymbol, {{0, {e_HIP_SYMBOL, cw_None}}}},
-  {sCudaMemcpyToSymbolAsync, {{0, {e_HIP_SYMBOL, cw_None}}}},
-  {sCudaGetSymbolSize, {{1, {e_HIP_SYMBOL, cw_None}}}},
-  {sCudaGetSymbolAddress, {{1, {e_HIP_SYMBOL, cw_None}}}},
-  {sCudaMemcpyFromSymbol, {{1, {e_HIP_SYMBOL, cw_None}}}},
-  {sCudaMemcpyFromSymbolAsync, {{1, {e_HIP_SYMBOL, cw_None}}}},
-  {sCudaGraphAddMemcpyNodeToSymbol, {{4, {e_HIP_SYMBOL, cw_None}}}},
-  {sCudaGraphAddMemcpyNodeFromSymbol, {{5, {e_HIP_SYMBOL, cw_None}}}},
-  {sCudaGraphMemcpyNodeSetParamsToSymbol, {{1, {e_HIP_SYMBOL, cw_None}}}},
-  {sCudaGraphMemcpyNodeSetParamsFromSymbol, {{2, {e_HIP_SYMBOL, cw_None}}}},
-  {sCudaGraphExecMemcpyNodeSetParamsToSymbol, {{2, {e_HIP_SYMBOL, cw_None}}}},
-  {sCudaGraphExecMemcpyNodeSetParamsFromSymbol, {{3, {e_HIP_SYMBOL, cw_None}}}},
-  {sCudaGetTextureReference, {{1, {e_HIP_SYMBOL, cw_None}}}},
-  {sCuOccupancyMaxPotentialBlockSize, {{3, {e_remove_argument, cw_DataLoss}}}},
-  {sCuOccupancyMaxPotentialBlockSizeWithFlags, {{3, {e_remove_argument, cw_DataLoss}}}},
-};
-
 void HipifyAction::RewriteString(StringRef s, clang::SourceLocation start) {
   auto &SM = getCompilerInstance().getSourceManager();
   size_t begin = 0;
+  PerfCounters &perf = Statistics::current().perf;
   while ((begin = s.find("cu", begin)) != StringRef::npos) {
     const size_t end = s.find_first_of(" ", begin + 4);
     StringRef name = s.slice(begin, end);
-    const auto found = CUDA_RENAMES_MAP().find(name);
-    if (found != CUDA_RENAMES_MAP().end()) {
-      StringRef repName = Statistics::isToRoc(found->second) ? found->second.rocName : found->second.hipName;
-      hipCounter counter = {s_string_literal, "", ConvTypes::CONV_LITERAL, ApiTypes::API_RUNTIME, found->second.supportDegree};
+    perf.count(PERF_RENAME_LOOKUPS);
+    hipCounter found;
+    if (FindRename(name, found)) {
+      perf.countHit(found.apiType);
+      StringRef repName = Statistics::isToRoc(found) ? found.rocName : found.hipName;
+      hipCounter counter = {s_string_literal, "", ConvTypes::CONV_LITERAL, ApiTypes::API_RUNTIME, found.supportDegree};
       Statistics::current().incrementCounter(counter, name.str());
       if (!Statistics::isUnsupported(counter)) {
         clang::SourceLocation sl = start.getLocWithOffset(begin + 1);
@@ -150,6 +104,7 @@ clang::SourceLocation HipifyAction::GetSubstrLocation(const std::string &str, co
 void HipifyAction::RewriteToken(const clang::Token &t) {
   // String literals containing CUDA references need fixing.
   if (t.is(clang::tok::string_literal)) {
+    Statistics::current().perf.count(PERF_STRING_LITERALS);
     StringRef s(t.getLiteralData(), t.getLength());
     RewriteString(unquoteStr(s), t.getLocation());
     return;
@@ -158,59 +113,85 @@ void HipifyAction::RewriteToken(const clang::Token &t) {
     return;
   }
   StringRef name = t.getRawIdentifier();
-  clang::SourceLocation sl = t.getLocation();
-  FindAndReplace(name, sl, CUDA_RENAMES_MAP());
+  Statistics::current().perf.count(PERF_RENAME_LOOKUPS);
+  hipCounter counter;
+  if (FindRename(name, counter)) Replace(name, counter, t.getLocation());
+}
+
+bool HipifyAction::FindRename(StringRef name, hipCounter &counter) const {
+  if (!options.bIncludeDrivenRenames) return findRename(name, counter);
+  // The database and the renames pruned to the target versions are hashed as a whole, so their renames are just filtered.
+  if (getMappingDB() || CUDA_TARGET_RENAMES_MAP()) return findRename(name, counter) && activeApis[counter.apiType];
+  for (unsigned api = 0; api < NUM_API_TYPES; ++api) {
+    if (!activeApis[api]) continue;
+    const auto &renames = CUDA_API_RENAMES_MAP(ApiTypes(api));
+    const auto found = renames.find(name);
+    if (found == renames.end()) continue;
+    counter = found->second;
+    return true;
+  }
+  return false;
 }
 
 void HipifyAction::FindAndReplace(StringRef name,
                                   clang::SourceLocation sl,
                                   const std::map<StringRef, hipCounter> &repMap,
                                   bool bReplace) {
+  PerfCounters &perf = Statistics::current().perf;
+  perf.count(PERF_RENAME_LOOKUPS);
   const auto found = repMap.find(name);
   if (found == repMap.end()) {
     // So it's an identifier, but not CUDA? Boring.
     return;
   }
-  Statistics::current().incrementCounter(found->second, name.str());
+  Replace(name, found->second, sl, bReplace);
+}
+
+void HipifyAction::Replace(StringRef name,
+                           const hipCounter &counter,
+                           clang::SourceLocation sl,
+                           bool bReplace) {
+  Statistics::current().perf.countHit(counter.apiType);
+  Statistics::current().incrementCounter(counter, name.str());
   clang::DiagnosticsEngine &DE = getCompilerInstance().getDiagnostics();
   // Warn about the deprecated identifier in CUDA but hipify it.
-  if (Statistics::isDeprecated(found->second)) {
+  if (Statistics::isDeprecated(counter)) {
     const auto ID = DE.getCustomDiagID(clang::DiagnosticsEngine::Warning, "'%0' is deprecated in CUDA.");
-    DE.Report(sl, ID) << found->first;
+    DE.Report(sl, ID) << name;
   }
   // Warn about the unsupported experimental identifier.
-  if (Statistics::isHipExperimental(found->second) &&!Experimental) {
+  if (Statistics::isHipExperimental(counter) && !options.bExperimental) {
     std::string sWarn;
-    Statistics::isToRoc(found->second) ? sWarn = sROC : sWarn = sHIP;
+    Statistics::isToRoc(counter) ? sWarn = sROC : sWarn = sHIP;
     sWarn = "" + sWarn;
     const auto ID = DE.getCustomDiagID(clang::DiagnosticsEngine::Warning, "'%0' is experimental in '%1'; to hipify it, use the '--experimental' option.");
-    DE.Report(sl, ID) << found->first << sWarn;
+    DE.Report(sl, ID) << name << sWarn;
     return;
   }
   // Warn about the identifier which is supported only for _v2 version of it
   // [NOTE]: Currently, only cuBlas is tracked for versioning and only for _v2;
   // cublas_v2.h has to be included in the source cuda file for hipification.
-  if (Statistics::isHipSupportedV2Only(found->second) && found->second.apiType == API_BLAS && !insertedBLASHeader_V2) {
+  if (Statistics::isHipSupportedV2Only(counter) && counter.apiType == API_BLAS && !insertedBLASHeader_V2) {
     std::string sWarn;
-    Statistics::isToRoc(found->second) ? sWarn = sROC : sWarn = sHIP;
+    Statistics::isToRoc(counter) ? sWarn = sROC : sWarn = sHIP;
     sWarn = "" + sWarn;
     const auto ID = DE.getCustomDiagID(clang::DiagnosticsEngine::Warning, "Only '%0_v2' version of '%0' is supported in '%1'; to hipify it, include 'cublas_v2.h' in the source.");
-    DE.Report(sl, ID) << found->first << sWarn;
+    DE.Report(sl, ID) << name << sWarn;
     return;
   }
   // Warn about the unsupported identifier.
-  if (Statistics::isUnsupported(found->second)) {
+  if (Statistics::isUnsupported(counter)) {
     std::string sWarn;
-    Statistics::isToRoc(found->second) ? sWarn = sROC : sWarn = sHIP;
+    Statistics::isToRoc(counter) ? sWarn = sROC : sWarn = sHIP;
     sWarn = "" + sWarn;
     const auto ID = DE.getCustomDiagID(clang::DiagnosticsEngine::Warning, "'%0' is unsupported in '%1'.");
-    DE.Report(sl, ID) << found->first << sWarn;
+    DE.Report(sl, ID) << name << sWarn;
     return;
   }
   if (!bReplace) {
     return;
   }
-  StringRef repName = Statistics::isToRoc(found->second) ? (found->second.rocName.empty() ? found->second.hipName : found->second.rocName) : found->second.hipName;
+  StringRef repName = Statistics::isToRoc(counter) ? (counter.rocName.empty() ? counter.hipName : counter.rocName) : counter.hipName;
   auto &SM = getCompilerInstance().getSourceManager();
   ct::Replacement Rep(SM, sl, name.size(), repName.str());
   clang::FullSourceLoc fullSL(sl, SM);
@@ -336,13 +317,15 @@ void HipifyAction::InclusionDirective(clang::SourceLocation hash_loc,
                                       clang::CharSourceRange filename_range,
                                       const clang::FileEntry*, StringRef,
                                       StringRef, const clang::Module*) {
+  const auto found = CUDA_INCLUDE_MAP.find(file_name);
+  // A CUDA library's header, included anywhere in the translation unit, activates the library's renames.
+  if (found != CUDA_INCLUDE_MAP.end()) activeApis[found->second.apiType] = true;
   auto &SM = getCompilerInstance().getSourceManager();
   if (!SM.isWrittenInMainFile(hash_loc)) return;
   if (!firstHeader) {
     firstHeader = true;
     firstHeaderLoc = hash_loc;
   }
-  const auto found = CUDA_INCLUDE_MAP.find(file_name);
   if (found == CUDA_INCLUDE_MAP.end()) return;
   bool exclude = Exclude(found->second);
   Statistics::current().incrementCounter(found->second, file_name.str());
@@ -389,13 +372,14 @@ void HipifyAction::PragmaDirective(clang::SourceLocation Loc, clang::PragmaIntro
 bool HipifyAction::cudaLaunchKernel(const mat::MatchFinder::MatchResult &Result) {
   auto *launchKernel = Result.Nodes.getNodeAs<clang::CUDAKernelCallExpr>(sCudaLaunchKernel);
   if (!launchKernel) return false;
+  Statistics::current().perf.countMatcher(MATCHER_CUDA_LAUNCH_KERNEL);
   auto *calleeExpr = launchKernel->getCallee();
   if (!calleeExpr) return false;
   auto *caleeDecl = launchKernel->getDirectCallee();
   if (!caleeDecl) return false;
   auto *config = launchKernel->getConfig();
   if (!config) return false;
-  if (CudaKernelExecutionSyntax && !HipKernelExecutionSyntax) return false;
+  if (options.bCudaKernelExecutionSyntax && !options.bHipKernelExecutionSyntax) return false;
   clang::SmallString<40> XStr;
   llvm::raw_svector_ostream OS(XStr);
   clang::LangOptions DefaultLangOptions;
@@ -465,6 +449,7 @@ bool HipifyAction::cudaLaunchKernel(const mat::MatchFinder::MatchResult &Result)
 
 bool HipifyAction::cudaDeviceFuncCall(const mat::MatchFinder::MatchResult &Result) {
   if (const clang::CallExpr *call = Result.Nodes.getNodeAs<clang::CallExpr>(sCudaDeviceFuncCall)) {
+    Statistics::current().perf.countMatcher(MATCHER_CUDA_DEVICE_FUNC_CALL);
     auto *funcDcl = call->getDirectCallee();
     if (!funcDcl) return false;
     FindAndReplace(funcDcl->getDeclName().getAsString(), llcompat::getBeginLoc(call), CUDA_DEVICE_FUNCTION_MAP, false);
@@ -475,6 +460,7 @@ bool HipifyAction::cudaDeviceFuncCall(const mat::MatchFinder::MatchResult &Resul
 
 bool HipifyAction::cubNamespacePrefix(const mat::MatchFinder::MatchResult &Result) {
   if (auto *decl = Result.Nodes.getNodeAs<clang::TypedefNameDecl>(sCubNamespacePrefix)) {
+    Statistics::current().perf.countMatcher(MATCHER_CUB_NAMESPACE_PREFIX);
     clang::QualType QT = decl->getUnderlyingType();
     auto *t = QT.getTypePtr();
     if (!t) return false;
@@ -496,6 +482,7 @@ bool HipifyAction::cubNamespacePrefix(const mat::MatchFinder::MatchResult &Resul
 
 bool HipifyAction::cubUsingNamespaceDecl(const mat::MatchFinder::MatchResult &Result) {
   if (auto *decl = Result.Nodes.getNodeAs<clang::UsingDirectiveDecl>(sCubUsingNamespaceDecl)) {
+    Statistics::current().perf.countMatcher(MATCHER_CUB_USING_NAMESPACE_DECL);
     if (auto nsd = decl->getNominatedNamespace()) {
       FindAndReplace(nsd->getDeclName().getAsString(), decl->getIdentLocation(), CUDA_CUB_NAMESPACE_MAP);
       return true;
@@ -506,6 +493,7 @@ bool HipifyAction::cubUsingNamespaceDecl(const mat::MatchFinder::MatchResult &Re
 
 bool HipifyAction::cubFunctionTemplateDecl(const mat::MatchFinder::MatchResult &Result) {
   if (auto *decl = Result.Nodes.getNodeAs<clang::FunctionTemplateDecl>(sCubFunctionTemplateDecl)) {
+    Statistics::current().perf.countMatcher(MATCHER_CUB_FUNCTION_TEMPLATE_DECL);
     auto *Tparams = decl->getTemplateParameters();
     bool ret = false;
     for (size_t I = 0; I < Tparams->size(); ++I) {
@@ -532,6 +520,7 @@ bool HipifyAction::cubFunctionTemplateDecl(const mat::MatchFinder::MatchResult &
 
 bool HipifyAction::cudaHostFuncCall(const mat::MatchFinder::MatchResult &Result) {
   if (auto *call = Result.Nodes.getNodeAs<clang::CallExpr>(sCudaHostFuncCall)) {
+    Statistics::current().perf.countMatcher(MATCHER_CUDA_HOST_FUNC_CALL);
     if (!call->getNumArgs()) return false;
     auto *funcDcl = call->getDirectCallee();
     if (!funcDcl) return false;
@@ -584,8 +573,9 @@ bool HipifyAction::cudaHostFuncCall(const mat::MatchFinder::MatchResult &Result)
 }
 
 void HipifyAction::insertReplacement(const ct::Replacement &rep, const clang::FullSourceLoc &fullSL) {
-  llcompat::insertReplacement(*replacements, rep);
-  if (PrintStats || PrintStatsCSV) {
+  bool inserted = llcompat::insertReplacement(*replacements, rep);
+  Statistics::current().perf.count(inserted ? PERF_REPLACEMENTS_INSERTED : PERF_REPLACEMENTS_REJECTED);
+  if (options.bCountTouched) {
     rep.getLength();
     Statistics::current().lineTouched(fullSL.getExpansionLineNumber());
     Statistics::current().bytesChanged(rep.getLength());
@@ -760,7 +750,7 @@ public:
 }
 
 bool HipifyAction::BeginInvocation(clang::CompilerInstance &CI) {
-  llcompat::RetainExcludedConditionalBlocks(CI);
+  llcompat::RetainExcludedConditionalBlocks(CI, !options.bSkipExcludedPPConditionalBlocks);
   return true;
 }
 
@@ -771,6 +761,8 @@ void HipifyAction::ExecuteAction() {
   // Now we're done futzing with the lexer, have the subclass proceeed with Sema and AST matching.
   clang::ASTFrontendAction::ExecuteAction();
   auto &SM = getCompilerInstance().getSourceManager();
+  // Compute the total bytes/lines of the input file from the buffer already loaded by the SourceManager.
+  Statistics::current().setSource(SM.getBufferData(SM.getMainFileID()));
   // Start lexing the specified input file.
   llcompat::Memory_Buffer FromFile = llcompat::getMemoryBuffer(SM);
   clang::Lexer RawLex(SM.getMainFileID(), FromFile, SM, PP.getLangOpts());
@@ -779,8 +771,10 @@ void HipifyAction::ExecuteAction() {
   // information to tell the difference between identifiers, string literals, and "other stuff". It also
   // ignores preprocessor directives, so this transformation will operate inside preprocessor-deleted code.
   clang::Token RawTok;
+  PerfCounters &perf = Statistics::current().perf;
   RawLex.LexFromRawLexer(RawTok);
   while (RawTok.isNot(clang::tok::eof)) {
+    perf.count(PERF_TOKENS_LEXED);
     RewriteToken(RawTok);
     RawLex.LexFromRawLexer(RawTok);
   }
@@ -34,13 +34,31 @@ namespace ct = clang::tooling;
 namespace mat = clang::ast_matchers;
 using namespace llvm;
 
+/**
+  * The options of a HipifyAction, which are passed to each action instead of being read from the command line,
+  * so that the actions of different hipifiers in the process (libhipify) don't share them.
+  */
+struct HipifyActionOptions {
+  bool bExperimental = false;
+  bool bCudaKernelExecutionSyntax = true;
+  bool bHipKernelExecutionSyntax = false;
+  bool bSkipExcludedPPConditionalBlocks = false;
+  bool bIncludeDrivenRenames = false;
+  // The touched lines and bytes are counted only if they are reported in the statistics
+  bool bCountTouched = false;
+};
+
 /**
   * A FrontendAction that hipifies CUDA programs.
   */
 class HipifyAction : public clang::ASTFrontendAction,
                      public mat::MatchFinder::MatchCallback {
+public:
+  typedef HipifyActionOptions Options;
+
 private:
   ct::Replacements *replacements;
+  const Options options;
   std::map<std::string, clang::SourceLocation> Ifndefs;
   std::unique_ptr<mat::MatchFinder> Finder;
   // CUDA implicitly adds its runtime header. We rewrite explicitly-provided CUDA includes with equivalent
@@ -57,6 +75,8 @@ private:
   bool insertedSPARSEHeader = false;
   bool insertedComplexHeader = false;
   bool firstHeader = false;
+  // The APIs, which renames are looked up with --include-driven-renames: Driver and Runtime ones, and the included libraries
+  bool activeApis[NUM_API_TYPES] = {true, true};
   bool pragmaOnce = false;
   clang::SourceLocation firstHeaderLoc;
   clang::SourceLocation pragmaOnceLoc;
@@ -64,12 +84,14 @@ private:
   void RewriteString(StringRef s, clang::SourceLocation start);
   // Replace a CUDA identifier with the corresponding hip identifier, if applicable.
   void RewriteToken(const clang::Token &t);
+  // Find the rename of a CUDA identifier: in the renames of the active APIs only with --include-driven-renames.
+  bool FindRename(StringRef name, hipCounter &counter) const;
   // Calculate str's SourceLocation in SourceRange sr
   clang::SourceLocation GetSubstrLocation(const std::string &str, const clang::SourceRange &sr);
 
 public:
-  explicit HipifyAction(ct::Replacements *replacements): clang::ASTFrontendAction(),
-    replacements(replacements) {}
+  HipifyAction(ct::Replacements *replacements, const Options &options): clang::ASTFrontendAction(),
+    replacements(replacements), options(options) {}
   // MatchCallback listeners
   bool cudaLaunchKernel(const mat::MatchFinder::MatchResult &Result);
   bool cudaDeviceFuncCall(const mat::MatchFinder::MatchResult &Result);
@@ -107,4 +129,5 @@ protected:
   std::unique_ptr<clang::ASTConsumer> CreateASTConsumer(clang::CompilerInstance &CI, StringRef InFile) override;
   bool Exclude(const hipCounter &hipToken);
   void FindAndReplace(StringRef name, clang::SourceLocation sl, const std::map<StringRef, hipCounter> &repMap, bool bReplace = true);
+  void Replace(StringRef name, const hipCounter &counter, clang::SourceLocation sl, bool bReplace = true);
 };
@@ -20,14 +20,11 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 
-#include "ArgParse.h"
 #include "LLVMCompat.h"
 #include "llvm/Support/Path.h"
 #include "clang/Lex/PreprocessorOptions.h"
 #include "clang/Frontend/CompilerInstance.h"
 
-const std::string sHipify = "[HIPIFY] ", sConflict = "conflict: ", sError = "error: ", sWarning = "warning: ";
-
 namespace llcompat {
 
 void PrintStackTraceOnErrorSignal() {
@@ -50,13 +47,18 @@ ct::Replacements &getReplacements(ct::RefactoringTool &Tool, StringRef file) {
 #endif
 }
 
-void insertReplacement(ct::Replacements &replacements, const ct::Replacement &rep) {
+bool insertReplacement(ct::Replacements &replacements, const ct::Replacement &rep) {
 #if LLVM_VERSION_MAJOR > 3
   // New clang added error checking to Replacements, and *insists* that you explicitly check it.
-  llvm::consumeError(replacements.add(rep));
+  llvm::Error err = replacements.add(rep);
+  if (err) {
+    llvm::consumeError(std::move(err));
+    return false;
+  }
+  return true;
 #else
   // In older versions, it's literally an std::set<Replacement>
-  replacements.insert(rep);
+  return replacements.insert(rep).second;
 #endif
 }
 
@@ -104,21 +106,6 @@ clang::SourceLocation getEndLoc(const clang::TypeLoc &typeLoc) {
 #endif
 }
 
-std::error_code real_path(const Twine &path, SmallVectorImpl<char> &output,
-                          bool expand_tilde) {
-#if LLVM_VERSION_MAJOR < 5
-  output.clear();
-  std::string s = path.str();
-  output.append(s.begin(), s.end());
-  if (sys::path::is_relative(path)) {
-    return sys::fs::make_absolute(output);
-  }
-  return std::error_code();
-#else
-  return sys::fs::real_path(path, output, expand_tilde);
-#endif
-}
-
 bool pragma_once_outside_header() {
 #if LLVM_VERSION_MAJOR < 4
   return false;
@@ -127,17 +114,17 @@ bool pragma_once_outside_header() {
 #endif
 }
 
-void RetainExcludedConditionalBlocks(clang::CompilerInstance &CI) {
+void RetainExcludedConditionalBlocks(clang::CompilerInstance &CI, bool bRetain) {
 #if LLVM_VERSION_MAJOR > 9
   clang::PreprocessorOptions &PPOpts = CI.getPreprocessorOpts();
-  PPOpts.RetainExcludedConditionalBlocks = !SkipExcludedPPConditionalBlocks;
+  PPOpts.RetainExcludedConditionalBlocks = bRetain;
 #endif
 }
 
-bool CheckCompatibility() {
+bool CheckCompatibility(bool bSkipExcludedPPConditionalBlocks) {
 #if LLVM_VERSION_MAJOR < 10
-  if (SkipExcludedPPConditionalBlocks) {
-    llvm::errs() << "\n" << sHipify << sWarning << "Option '" << SkipExcludedPPConditionalBlocks.ArgStr.str() << "' is supported starting from LLVM version 10.0\n";
+  if (bSkipExcludedPPConditionalBlocks) {
+    llvm::errs() << "\n" << sHipify << sWarning << "Option 'skip-excluded-preprocessor-conditional-blocks' is supported starting from LLVM version 10.0\n";
   }
 #endif
   return true;
@@ -159,10 +146,34 @@ Memory_Buffer getMemoryBuffer(const clang::SourceManager &SM) {
 #endif
 }
 
-void addTargetIfNeeded(ct::RefactoringTool& Tool) {
+void addTargetIfNeeded(std::vector<std::string> &args) {
 #if defined(_WIN32) && LLVM_VERSION_MAJOR >= 16
-  std::string sTarget = "--target=x86_64-pc-windows-msvc";
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster(sTarget.c_str(), ct::ArgumentInsertPosition::BEGIN));
+  args.push_back("--target=x86_64-pc-windows-msvc");
+#endif
+}
+
+bool runToolOnCodeWithArgs(std::unique_ptr<clang::FrontendAction> action, StringRef code,
+                           const std::vector<std::string> &args, StringRef fileName) {
+#if LLVM_VERSION_MAJOR < 10
+  return ct::runToolOnCodeWithArgs(action.release(), code, args, fileName);
+#else
+  return ct::runToolOnCodeWithArgs(std::move(action), code, args, fileName);
+#endif
+}
+
+bool applyAllReplacements(StringRef code, const ct::Replacements &replacements, std::string &result) {
+#if LLVM_VERSION_MAJOR > 3
+  llvm::Expected<std::string> applied = ct::applyAllReplacements(code, replacements);
+  if (!applied) {
+    llvm::consumeError(applied.takeError());
+    return false;
+  }
+  result = std::move(*applied);
+  return true;
+#else
+  // In older versions, an empty string is returned on failure
+  result = ct::applyAllReplacements(code, replacements);
+  return !result.empty() || code.empty();
 #endif
 }
 
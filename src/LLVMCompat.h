@@ -25,13 +25,14 @@ THE SOFTWARE.
 #include <clang/Tooling/Core/Replacement.h>
 #include <clang/Tooling/Refactoring.h>
 #include <llvm/Support/Signals.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <clang/Lex/Token.h>
 #include <clang/Lex/Preprocessor.h>
+#include "LLVMCompatSupport.h"
 
 namespace ct = clang::tooling;
 
-extern const std::string sHipify, sConflict, sError, sWarning;
-
 // Things for papering over the differences between different LLVM versions.
 
 namespace llcompat {
@@ -68,9 +69,10 @@ using namespace llvm;
 ct::Replacements &getReplacements(ct::RefactoringTool &Tool, StringRef file);
 
 /**
-  * Add a Replacement to a Replacements.
+  * Add a Replacement to a Replacements; return false if the Replacement is rejected,
+  * e.g. due to a conflict with another one.
   */
-void insertReplacement(ct::Replacements &replacements, const ct::Replacement &rep);
+bool insertReplacement(ct::Replacements &replacements, const ct::Replacement &rep);
 
 /**
   * Version-agnostic version of Preprocessor::EnterTokenStream().
@@ -80,14 +82,11 @@ void EnterPreprocessorTokenStream(clang::Preprocessor &_pp,
                                   size_t len,
                                   bool DisableMacroExpansion);
 
-std::error_code real_path(const Twine &path, SmallVectorImpl<char> &output,
-                          bool expand_tilde = false);
-
 bool pragma_once_outside_header();
 
-void RetainExcludedConditionalBlocks(clang::CompilerInstance &CI);
+void RetainExcludedConditionalBlocks(clang::CompilerInstance &CI, bool bRetain);
 
-bool CheckCompatibility();
+bool CheckCompatibility(bool bSkipExcludedPPConditionalBlocks);
 
 clang::SourceLocation getEndOfExpansionRangeForLoc(const clang::SourceManager &SM, const clang::SourceLocation &loc);
 
@@ -99,6 +98,18 @@ clang::SourceLocation getEndOfExpansionRangeForLoc(const clang::SourceManager &S
 
 Memory_Buffer getMemoryBuffer(const clang::SourceManager &SM);
 
-void addTargetIfNeeded(ct::RefactoringTool& Tool);
+void addTargetIfNeeded(std::vector<std::string> &args);
+
+/**
+  * Version-agnostic runToolOnCodeWithArgs: run the action on the in-memory code of the file;
+  * return false if the code failed to be parsed.
+  */
+bool runToolOnCodeWithArgs(std::unique_ptr<clang::FrontendAction> action, StringRef code,
+                           const std::vector<std::string> &args, StringRef fileName);
+
+/**
+  * Version-agnostic applyAllReplacements: return false if the replacements can't be applied to the code.
+  */
+bool applyAllReplacements(StringRef code, const ct::Replacements &replacements, std::string &result);
 
 } // namespace llcompat
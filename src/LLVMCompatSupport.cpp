@@ -0,0 +1,61 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "LLVMCompatSupport.h"
+#include "llvm/Support/Path.h"
+
+const std::string sHipify = "[HIPIFY] ", sConflict = "conflict: ", sError = "error: ", sWarning = "warning: ";
+
+namespace llcompat {
+
+std::error_code real_path(const Twine &path, SmallVectorImpl<char> &output,
+                          bool expand_tilde) {
+#if LLVM_VERSION_MAJOR < 5
+  output.clear();
+  std::string s = path.str();
+  output.append(s.begin(), s.end());
+  if (sys::path::is_relative(path)) {
+    return sys::fs::make_absolute(output);
+  }
+  return std::error_code();
+#else
+  return sys::fs::real_path(path, output, expand_tilde);
+#endif
+}
+
+sys::fs::recursive_directory_iterator recursive_directory_iterator(const Twine &path, std::error_code &ec) {
+#if LLVM_VERSION_MAJOR < 5
+  return sys::fs::recursive_directory_iterator(path, ec);
+#else
+  return sys::fs::recursive_directory_iterator(path, ec, false);
+#endif
+}
+
+ErrorOr<std::unique_ptr<MemoryBuffer>> getMappedFile(const Twine &path) {
+#if LLVM_VERSION_MAJOR < 13
+  return MemoryBuffer::getFile(path, -1, false);
+#else
+  return MemoryBuffer::getFile(path, false, false);
+#endif
+}
+
+} // namespace llcompat
@@ -0,0 +1,57 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+// The compatibility things, which need LLVMSupport only, so that the tools without clang (hipify-fast, hipify-tables) use them as well.
+
+#include <memory>
+#include <string>
+#include <system_error>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/Twine.h>
+#include <llvm/Support/ErrorOr.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+extern const std::string sHipify, sConflict, sError, sWarning;
+
+namespace llcompat {
+
+using namespace llvm;
+
+std::error_code real_path(const Twine &path, SmallVectorImpl<char> &output,
+                          bool expand_tilde = false);
+
+/**
+  * Version-agnostic recursive_directory_iterator, which doesn't follow symbolic links
+  * where it is supported (LLVM 5.0 and newer).
+  */
+sys::fs::recursive_directory_iterator recursive_directory_iterator(const Twine &path, std::error_code &ec);
+
+/**
+  * Version-agnostic MemoryBuffer::getFile without a null terminator, so that a big enough file is mapped
+  * into memory instead of being read, and its pages are shared by all the processes mapping it.
+  */
+ErrorOr<std::unique_ptr<MemoryBuffer>> getMappedFile(const Twine &path);
+
+} // namespace llcompat
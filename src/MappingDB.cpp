@@ -0,0 +1,310 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "MappingDB.h"
+#include <cstring>
+#include <vector>
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+#include "CUDA2HIP.h"
+#include "LLVMCompatSupport.h"
+
+using namespace llvm;
+
+namespace {
+
+const char sMagic[8] = {'H', 'I', 'P', 'I', 'F', 'Y', 'D', 'B'};
+const uint32_t byteOrderMark = 0x01020304;
+
+struct FileHeader {
+  char magic[8];
+  uint32_t formatVersion;
+  uint32_t byteOrder;
+  uint32_t hipVersion;
+  uint32_t numTables;
+  uint32_t stringsOffset;
+  uint32_t stringsSize;
+};
+
+struct TableHeader {
+  uint32_t count;
+  uint32_t recordSize;
+  uint32_t recordsOffset;
+  uint32_t indexOffset;
+  uint32_t indexSize;
+};
+
+// The records are arrays of 32-bit words, the first two of which are the name's offset in the string pool and its size
+enum CounterRecord {
+  CR_NAME = 0, CR_NAME_SIZE, CR_HIP, CR_HIP_SIZE, CR_ROC, CR_ROC_SIZE, CR_TYPE, CR_API_TYPE, CR_API_SECTION, CR_SUPPORT_DEGREE, CR_SIZE
+};
+
+const uint32_t recordSizes[MappingDB::NUM_TABLES] = {CR_SIZE};
+
+std::unique_ptr<MappingDB> mappingDB;
+
+// FNV-1a: the index must not depend on the hash functions of the LLVM version
+uint32_t hash(StringRef s) {
+  uint32_t h = 2166136261u;
+  for (unsigned char c : s) {
+    h ^= c;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+// The number of the index's buckets: a power of two, so that at most a half of them is used
+uint32_t getIndexSize(size_t count) {
+  uint32_t size = 2;
+  while (size < count * 2) size *= 2;
+  return size;
+}
+
+class Writer {
+public:
+  void addTable(const std::map<StringRef, hipCounter> &map) {
+    std::vector<uint32_t> &records = newTable(map.size(), CR_SIZE);
+    for (const auto &m : map) {
+      addString(records, m.first);
+      addString(records, m.second.hipName);
+      addString(records, m.second.rocName);
+      records.push_back(m.second.type);
+      records.push_back(m.second.apiType);
+      records.push_back(m.second.apiSection);
+      records.push_back(m.second.supportDegree);
+    }
+  }
+
+  void write(raw_ostream &OS) {
+    uint32_t offset = sizeof(FileHeader) + sizeof(TableHeader) * MappingDB::NUM_TABLES;
+    std::vector<std::vector<uint32_t>> indices(tables.size());
+    for (size_t t = 0; t < tables.size(); ++t) {
+      TableHeader &header = headers[t];
+      header.recordsOffset = offset;
+      offset += header.count * header.recordSize * sizeof(uint32_t);
+      header.indexSize = getIndexSize(header.count);
+      header.indexOffset = offset;
+      offset += header.indexSize * sizeof(uint32_t);
+      std::vector<uint32_t> &index = indices[t];
+      index.assign(header.indexSize, 0);
+      for (uint32_t r = 0; r < header.count; ++r) {
+        const uint32_t *record = &tables[t][r * header.recordSize];
+        uint32_t bucket = hash(StringRef(strings).substr(record[0], record[1])) & (header.indexSize - 1);
+        while (index[bucket]) bucket = (bucket + 1) & (header.indexSize - 1);
+        index[bucket] = r + 1;
+      }
+    }
+    FileHeader fileHeader;
+    memcpy(fileHeader.magic, sMagic, sizeof(sMagic));
+    fileHeader.formatVersion = MappingDB::formatVersion;
+    fileHeader.byteOrder = byteOrderMark;
+    fileHeader.hipVersion = HIP_LATEST;
+    fileHeader.numTables = MappingDB::NUM_TABLES;
+    fileHeader.stringsOffset = offset;
+    fileHeader.stringsSize = static_cast<uint32_t>(strings.size());
+    OS.write(reinterpret_cast<const char *>(&fileHeader), sizeof(fileHeader));
+    OS.write(reinterpret_cast<const char *>(headers), sizeof(headers));
+    for (size_t t = 0; t < tables.size(); ++t) {
+      OS.write(reinterpret_cast<const char *>(tables[t].data()), tables[t].size() * sizeof(uint32_t));
+      OS.write(reinterpret_cast<const char *>(indices[t].data()), indices[t].size() * sizeof(uint32_t));
+    }
+    OS << strings;
+  }
+
+private:
+  std::vector<std::vector<uint32_t>> tables;
+  TableHeader headers[MappingDB::NUM_TABLES] = {};
+  std::string strings;
+  StringMap<uint32_t> stringOffsets;
+
+  std::vector<uint32_t> &newTable(size_t count, uint32_t recordSize) {
+    TableHeader &header = headers[tables.size()];
+    header.count = static_cast<uint32_t>(count);
+    header.recordSize = recordSize;
+    tables.emplace_back();
+    tables.back().reserve(count * recordSize);
+    return tables.back();
+  }
+
+  // The HIP names are mostly repeated, so the strings are pooled
+  void addString(std::vector<uint32_t> &records, StringRef s) {
+    auto inserted = stringOffsets.insert({s, static_cast<uint32_t>(strings.size())});
+    if (inserted.second) strings += s.str();
+    records.push_back(inserted.first->second);
+    records.push_back(static_cast<uint32_t>(s.size()));
+  }
+};
+
+} // namespace
+
+bool MappingDB::write(const std::string &fileName, std::string &sErrorMessage) {
+  Writer writer;
+  // In the order of the Table enumerators
+  writer.addTable(CUDA_RENAMES_MAP());
+  // The database is written into a temporary file, which then replaces the existing one,
+  // so that the processes, which have the existing one mapped, keep reading it intact.
+  int fd;
+  SmallString<128> tmpFile;
+  std::error_code EC = sys::fs::createUniqueFile(fileName + "-%%%%%%", fd, tmpFile);
+  if (EC) {
+    sErrorMessage = EC.message() + ": " + fileName;
+    return false;
+  }
+  {
+    raw_fd_ostream OS(fd, true);
+    writer.write(OS);
+    OS.close();
+    if (OS.has_error()) {
+      OS.clear_error();
+      sys::fs::remove(tmpFile);
+      sErrorMessage = "while writing " + tmpFile.str().str();
+      return false;
+    }
+  }
+  EC = sys::fs::rename(tmpFile, fileName);
+  if (EC) {
+    sys::fs::remove(tmpFile);
+    sErrorMessage = EC.message() + ": " + fileName;
+    return false;
+  }
+  return true;
+}
+
+std::unique_ptr<MappingDB> MappingDB::open(const std::string &fileName, std::string &sErrorMessage) {
+  auto buffer = llcompat::getMappedFile(fileName);
+  if (!buffer) {
+    sErrorMessage = buffer.getError().message() + ": mapping database: " + fileName;
+    return nullptr;
+  }
+  StringRef data = buffer.get()->getBuffer();
+  sErrorMessage = "mapping database: " + fileName + ": ";
+  if (data.size() < sizeof(sMagic) || memcmp(data.data(), sMagic, sizeof(sMagic))) {
+    sErrorMessage += "not a mapping database";
+    return nullptr;
+  }
+  if (data.size() < sizeof(FileHeader) + sizeof(TableHeader) * NUM_TABLES) {
+    sErrorMessage += "the file is truncated";
+    return nullptr;
+  }
+  FileHeader fileHeader;
+  memcpy(&fileHeader, data.data(), sizeof(fileHeader));
+  if (fileHeader.formatVersion != formatVersion || fileHeader.byteOrder != byteOrderMark || fileHeader.numTables != NUM_TABLES) {
+    sErrorMessage += "unsupported format version " + std::to_string(fileHeader.formatVersion) + " or byte order; regenerate it";
+    return nullptr;
+  }
+  if (fileHeader.hipVersion != HIP_LATEST) {
+    sErrorMessage += "generated for the tables of another HIP version than " + Statistics::getHipVersion(HIP_LATEST) + "; regenerate it";
+    return nullptr;
+  }
+  if (uint64_t(fileHeader.stringsOffset) + fileHeader.stringsSize > data.size()) {
+    sErrorMessage += "the file is truncated";
+    return nullptr;
+  }
+  std::unique_ptr<MappingDB> db(new MappingDB());
+  db->strings = data.substr(fileHeader.stringsOffset, fileHeader.stringsSize);
+  for (unsigned t = 0; t < NUM_TABLES; ++t) {
+    TableHeader header;
+    memcpy(&header, data.data() + sizeof(FileHeader) + sizeof(TableHeader) * t, sizeof(header));
+    bool bValid = header.recordSize == recordSizes[t] && header.indexSize && !(header.indexSize & (header.indexSize - 1)) &&
+                  header.indexSize > header.count && !(header.recordsOffset % sizeof(uint32_t)) && !(header.indexOffset % sizeof(uint32_t)) &&
+                  uint64_t(header.recordsOffset) + uint64_t(header.count) * header.recordSize * sizeof(uint32_t) <= data.size() &&
+                  uint64_t(header.indexOffset) + uint64_t(header.indexSize) * sizeof(uint32_t) <= data.size();
+    if (!bValid) {
+      sErrorMessage += "the table " + std::to_string(t) + " is corrupted";
+      return nullptr;
+    }
+    TableInfo &table = db->tables[t];
+    table.records = data.data() + header.recordsOffset;
+    table.count = header.count;
+    table.recordSize = header.recordSize;
+    table.index = reinterpret_cast<const uint32_t *>(data.data() + header.indexOffset);
+    table.indexSize = header.indexSize;
+  }
+  db->buffer = std::move(buffer.get());
+  sErrorMessage.clear();
+  return db;
+}
+
+unsigned MappingDB::size(Table table) const {
+  return tables[table].count;
+}
+
+StringRef MappingDB::getString(uint32_t offset, uint32_t size) const {
+  if (uint64_t(offset) + size > strings.size()) return StringRef();
+  return strings.substr(offset, size);
+}
+
+const uint32_t *MappingDB::findRecord(Table table, StringRef name) const {
+  const TableInfo &info = tables[table];
+  for (uint32_t bucket = hash(name) & (info.indexSize - 1), probes = 0; probes < info.indexSize; bucket = (bucket + 1) & (info.indexSize - 1), ++probes) {
+    uint32_t r = info.index[bucket];
+    if (!r) return nullptr;
+    if (r > info.count) continue;
+    const uint32_t *record = reinterpret_cast<const uint32_t *>(info.records) + (r - 1) * info.recordSize;
+    if (record[1] == name.size() && getString(record[0], record[1]) == name) return record;
+  }
+  return nullptr;
+}
+
+bool MappingDB::find(Table table, StringRef name, hipCounter &counter) const {
+  if (recordSizes[table] != CR_SIZE) return false;
+  const uint32_t *record = findRecord(table, name);
+  if (!record || record[CR_TYPE] >= NUM_CONV_TYPES || record[CR_API_TYPE] >= NUM_API_TYPES) return false;
+  counter = {getString(record[CR_HIP], record[CR_HIP_SIZE]), getString(record[CR_ROC], record[CR_ROC_SIZE]), ConvTypes(record[CR_TYPE]),
+             ApiTypes(record[CR_API_TYPE]), record[CR_API_SECTION], record[CR_SUPPORT_DEGREE]};
+  return true;
+}
+
+bool openMappingDB(const std::string &fileName, std::string &sErrorMessage) {
+  mappingDB = MappingDB::open(fileName, sErrorMessage);
+  return mappingDB != nullptr;
+}
+
+const MappingDB *getMappingDB() {
+  return mappingDB.get();
+}
+
+bool findRename(StringRef name, hipCounter &counter) {
+  // The renames pruned to the target versions are built from all the maps, including the overlay, so the database isn't used.
+  if (const auto *renames = CUDA_TARGET_RENAMES_MAP()) {
+    const auto found = renames->find(name);
+    if (found == renames->end()) return false;
+    counter = found->second;
+    return true;
+  }
+  if (mappingDB) {
+    const auto &overlay = CUDA_OVERLAY_MAP();
+    const auto found = overlay.find(name);
+    if (found != overlay.end()) {
+      counter = found->second;
+      return true;
+    }
+    return mappingDB->find(MappingDB::TABLE_RENAMES, name, counter);
+  }
+  const auto found = CUDA_RENAMES_MAP().find(name);
+  if (found == CUDA_RENAMES_MAP().end()) return false;
+  counter = found->second;
+  return true;
+}
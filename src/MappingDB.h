@@ -0,0 +1,89 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "Statistics.h"
+
+/**
+  * The binary mapping database: the hipCounter records of the renames with an open addressing hash index per table,
+  * in a single versioned file, which is mapped into memory as is. The other maps are small static ones, which don't
+  * need a database, and the versions are used only for pruning the renames to the target versions, which bypasses it.
+  *
+  * Opening the database doesn't build any map, so it takes microseconds, and the pages of the file are shared
+  * by all the processes on the host, which have it opened. The records are in the byte order of the host.
+  */
+class MappingDB {
+public:
+  enum Table {
+    // CUDA_RENAMES_MAP(), including the overlay's entries, if any
+    TABLE_RENAMES = 0,
+    NUM_TABLES
+  };
+
+  // Is incremented on any change of the file layout
+  static const uint32_t formatVersion = 2;
+
+  // Writes the database of the tables into the file, replacing the existing one atomically
+  static bool write(const std::string &fileName, std::string &sErrorMessage);
+  // Opens the database, checking its format and the HIP version, which it is generated for
+  static std::unique_ptr<MappingDB> open(const std::string &fileName, std::string &sErrorMessage);
+
+  unsigned size(Table table) const;
+  bool find(Table table, llvm::StringRef name, hipCounter &counter) const;
+
+private:
+  struct TableInfo {
+    const char *records = nullptr;
+    uint32_t count = 0;
+    uint32_t recordSize = 0;
+    const uint32_t *index = nullptr;
+    uint32_t indexSize = 0;
+  };
+
+  std::unique_ptr<llvm::MemoryBuffer> buffer;
+  llvm::StringRef strings;
+  TableInfo tables[NUM_TABLES];
+
+  MappingDB() = default;
+  // The record of the name in the table, or nullptr
+  const uint32_t *findRecord(Table table, llvm::StringRef name) const;
+  llvm::StringRef getString(uint32_t offset, uint32_t size) const;
+};
+
+// Opens the mapping database of --mapping-db; the renames are then looked up in it instead of CUDA_RENAMES_MAP(),
+// unless the target versions are set.
+bool openMappingDB(const std::string &fileName, std::string &sErrorMessage);
+// The mapping database opened by --mapping-db, or nullptr
+const MappingDB *getMappingDB();
+
+/**
+  * Finds the rename of the CUDA identifier: in CUDA_TARGET_RENAMES_MAP(), if the target versions are set,
+  * otherwise in the overlay and the opened mapping database, if any, otherwise in CUDA_RENAMES_MAP().
+  */
+bool findRename(llvm::StringRef name, hipCounter &counter);
@@ -0,0 +1,91 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "MappingOverlay.h"
+#include <set>
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "CUDA2HIP.h"
+
+using namespace llvm;
+
+namespace {
+
+// The overlay's names, which are referred to by the StringRefs of CUDA_OVERLAY_MAP
+std::set<std::string> overlayNames;
+
+StringRef intern(StringRef s) {
+  return *overlayNames.insert(s.str()).first;
+}
+
+template<typename T, unsigned N>
+bool findName(StringRef s, const char *(&names)[N], const char *(&enumerators)[N], T &result) {
+  for (unsigned i = 0; i < N; ++i) {
+    if (s != names[i] && s != enumerators[i]) continue;
+    result = static_cast<T>(i);
+    return true;
+  }
+  return false;
+}
+
+} // namespace
+
+bool loadMappingOverlay(const std::string &fileName, std::string &sErrorMessage) {
+  auto buffer = MemoryBuffer::getFile(fileName);
+  if (!buffer) {
+    sErrorMessage = buffer.getError().message() + ": mapping overlay: " + fileName;
+    return false;
+  }
+  auto &overlay = CUDA_OVERLAY_MAP();
+  SmallVector<StringRef, 64> lines;
+  buffer.get()->getBuffer().split(lines, '\n');
+  unsigned lineNum = 0;
+  for (StringRef line : lines) {
+    ++lineNum;
+    line = line.rtrim("\r");
+    if (line.trim().empty() || line.ltrim().front() == '#') continue;
+    std::string sLocation = fileName + ":" + std::to_string(lineNum) + ": ";
+    SmallVector<StringRef, 5> columns;
+    line.split(columns, '\t');
+    for (auto &c : columns) c = c.trim();
+    if (columns.size() < 4 || columns.size() > 5 || columns[0].empty() || columns[1].empty()) {
+      sErrorMessage = sLocation + "expected <CUDA name> <HIP name> <conversion type> <API type> [<ROC name>] separated by tabs";
+      return false;
+    }
+    ConvTypes type;
+    if (!findName(columns[2], counterNames, counterTypes, type)) {
+      sErrorMessage = sLocation + "unknown conversion type: " + columns[2].str();
+      return false;
+    }
+    ApiTypes api;
+    if (!findName(columns[3], apiNames, apiTypes, api)) {
+      sErrorMessage = sLocation + "unknown API type: " + columns[3].str();
+      return false;
+    }
+    StringRef hipName = intern(columns[1]);
+    StringRef rocName = columns.size() == 5 && !columns[4].empty() ? intern(columns[4]) : hipName;
+    overlay[intern(columns[0])] = {hipName, rocName, type, api, 0, FULL};
+  }
+  return true;
+}
@@ -0,0 +1,37 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <string>
+
+/**
+  * Loads the user's CUDA to HIP mappings from a tab-separated file into CUDA_OVERLAY_MAP, which takes precedence over the built-in maps.
+  *
+  * Each non-empty line, except the ones starting with '#', is an entry of 4 or 5 columns:
+  * <CUDA name> <HIP name> <conversion type> <API type> [<ROC name>],
+  * where the conversion type is either a name ("memory") or an enumerator ("CONV_MEMORY") of ConvTypes,
+  * and the API type is either a name ("CUDA RT API") or an enumerator ("API_RUNTIME") of ApiTypes.
+  * Should be called before the first use of CUDA_RENAMES_MAP(); on failure, returns false with the error in sErrorMessage.
+  */
+bool loadMappingOverlay(const std::string &fileName, std::string &sErrorMessage);
@@ -0,0 +1,47 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <string>
+
+// The values of the options, which are read by the code shared by hipify-clang, the hipify library, hipify-fast,
+// and hipify-tables. They are plain variables, so that the library doesn't register any command line options in the
+// process, which embeds it; each tool binds its own command line options to them by cl::location.
+
+// Translate to roc instead of hip where it is possible
+extern bool TranslateToRoc;
+// Translate to miopen instead of hip where it is possible
+extern bool TranslateToMIOpen;
+// The output directory of the documentation
+extern std::string OutputDir;
+// The output directory of hipify-perl
+extern std::string OutputHipifyPerlDir;
+// The output directory of the Python map
+extern std::string OutputPythonMapDir;
+// Generate hipify-perl as a driver script and per-API modules
+extern bool GeneratePerlModules;
+// Documentation format: 'full' (default), 'strict', or 'compact'
+extern std::string DocFormat;
+// Save the temporary files of the generators
+extern bool SaveTemps;
@@ -29,7 +29,7 @@ THE SOFTWARE.
 namespace ct = clang::tooling;
 
 /**
-  * A FrontendActionFactory that propagates a set of Replacements into the FrontendAction.
+  * A FrontendActionFactory that propagates a set of Replacements and the options into the FrontendAction.
   * This is necessary boilerplate for using a custom FrontendAction with a RefactoringTool.
   *
   * @tparam T The FrontendAction to create.
@@ -37,19 +37,21 @@ namespace ct = clang::tooling;
 template <typename T>
 class ReplacementsFrontendActionFactory : public ct::FrontendActionFactory {
   ct::Replacements *replacements;
+  const typename T::Options options;
 
 public:
-  explicit ReplacementsFrontendActionFactory(ct::Replacements *r):
+  ReplacementsFrontendActionFactory(ct::Replacements *r, const typename T::Options &options):
     ct::FrontendActionFactory(),
-    replacements(r) {}
+    replacements(r),
+    options(options) {}
 
 #if LLVM_VERSION_MAJOR < 10
   clang::FrontendAction *create() override {
-    return new T(replacements);
+    return new T(replacements, options);
   }
 #else
   std::unique_ptr <clang::FrontendAction> create() override {
-    return std::unique_ptr<clang::FrontendAction>(new T(replacements));
+    return std::unique_ptr<clang::FrontendAction>(new T(replacements, options));
   }
 #endif
 };
@@ -0,0 +1,397 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "SourceQueue.h"
+#include "StringUtils.h"
+#include "LLVMCompatSupport.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/ConvertUTF.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Regex.h"
+#include "llvm/Support/StringSaver.h"
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace llvm;
+
+const std::vector<std::string> defaultSourceExtensions {
+  "cu", "cuh", "cpp", "cxx", "cc", "c", "h", "hpp", "hxx", "inc", "inl", "hdl"
+};
+
+SourceQueue::~SourceQueue() {
+  join();
+}
+
+void SourceQueue::join() {
+  for (auto &producer : producers)
+    producer.join();
+  producers.clear();
+}
+
+void SourceQueue::push(Source source) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    sources.push_back(std::move(source));
+  }
+  cv.notify_one();
+}
+
+void SourceQueue::produce(std::function<void(SourceQueue &)> producer) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++running;
+  }
+  producers.emplace_back([this, producer]() {
+    producer(*this);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      --running;
+    }
+    cv.notify_all();
+  });
+}
+
+bool SourceQueue::pop(Source &source) {
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [this]() { return !sources.empty() || running == 0; });
+  if (sources.empty()) return false;
+  source = std::move(sources.front());
+  sources.pop_front();
+  return true;
+}
+
+void walkSourceDirectory(const std::string &dir, const std::vector<std::string> &extensions,
+  const std::vector<std::string> &ignorePatterns, SourceQueue &queue) {
+  StringSet<> exts;
+  for (const auto &ext : extensions)
+    exts.insert(StringRef(ext).ltrim('.').lower());
+  auto isIgnored = [&ignorePatterns](StringRef relativePath) {
+    StringRef name = sys::path::filename(relativePath);
+    for (const auto &pattern : ignorePatterns)
+      if (matchesWildcard(name, pattern) || matchesWildcard(relativePath, pattern)) return true;
+    return false;
+  };
+  std::error_code EC;
+  sys::fs::recursive_directory_iterator end;
+  for (auto it = llcompat::recursive_directory_iterator(dir, EC); it != end && !EC; it.increment(EC)) {
+    std::string path = it->path();
+    StringRef relativePath = StringRef(path).drop_front(dir.size());
+    relativePath = relativePath.ltrim(sys::path::get_separator());
+    // As with find, symbolic links to files are hipified, but symbolic links to directories are not walked
+    sys::fs::file_status status;
+    if (sys::fs::status(path, status)) continue;
+    if (sys::fs::is_directory(status)) {
+      if (isIgnored(relativePath)) it.no_push();
+      continue;
+    }
+    if (!sys::fs::is_regular_file(status) || isIgnored(relativePath)) continue;
+    StringRef ext = sys::path::extension(path);
+    if (ext.empty() || !exts.count(ext.drop_front().lower())) continue;
+    queue.push({path, relativePath.str(), ""});
+  }
+  if (EC)
+    queue.push({dir, "", EC.message() + ": source directory: " + dir});
+}
+
+void readSourceList(const std::string &fileName, SourceQueue &queue) {
+  std::ifstream file;
+  if (fileName != "-") {
+    file.open(fileName, std::ios_base::binary);
+    if (!file) {
+      queue.push({fileName, "", std::string(std::strerror(errno)) + ": source list: " + fileName});
+      return;
+    }
+  }
+  std::istream &in = fileName == "-" ? std::cin : file;
+  // Each path is pushed as soon as it is read, while the rest of the list might not be written yet.
+  // The separator is the first newline or NUL character read, as a NUL-separated list might have no newlines at all.
+  char separator = '\n';
+  std::string line;
+  for (char c; in.get(c); line += c) {
+    if (c == '\n' || c == '\0') {
+      separator = c;
+      break;
+    }
+  }
+  do {
+    StringRef path(line);
+    if (separator == '\n') path = path.rtrim('\r');
+    if (!path.empty()) queue.push({path.str(), "", ""});
+  } while (std::getline(in, line, separator));
+  if (in.bad())
+    queue.push({fileName, "", "reading failed: source list: " + fileName});
+}
+
+namespace {
+
+void skipWhitespace(StringRef text, size_t &pos) {
+  while (pos < text.size() && isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+}
+
+// Skip the JSON value at pos; the value isn't validated, but a string or an array or object is skipped as a whole.
+bool skipJSONValue(StringRef text, size_t &pos) {
+  unsigned depth = 0;
+  bool bInString = false, bEscaped = false;
+  size_t begin = pos;
+  for (; pos < text.size(); ++pos) {
+    char c = text[pos];
+    if (bInString) {
+      if (bEscaped) bEscaped = false;
+      else if (c == '\\') bEscaped = true;
+      else if (c == '"') bInString = false;
+      if (!bInString && depth == 0) {
+        ++pos;
+        return true;
+      }
+      continue;
+    }
+    if (c == '"') {
+      bInString = true;
+    } else if (c == '{' || c == '[') {
+      ++depth;
+    } else if (c == '}' || c == ']') {
+      if (depth == 0) return pos > begin;
+      if (--depth == 0) {
+        ++pos;
+        return true;
+      }
+    } else if (depth == 0 && (c == ',' || isspace(static_cast<unsigned char>(c)))) {
+      // The end of a number, true, false, or null
+      return pos > begin;
+    }
+  }
+  return depth == 0 && !bInString && pos > begin;
+}
+
+bool decodeJSONString(StringRef raw, std::string &value) {
+  if (raw.size() < 2 || raw.front() != '"' || raw.back() != '"') return false;
+  auto readHex = [&raw](size_t pos, unsigned &code) {
+    return pos + 4 < raw.size() && !raw.substr(pos, 4).getAsInteger(16, code);
+  };
+  value.clear();
+  for (size_t i = 1; i + 1 < raw.size(); ++i) {
+    if (raw[i] != '\\') {
+      value += raw[i];
+      continue;
+    }
+    if (++i + 1 >= raw.size()) return false;
+    switch (raw[i]) {
+      case '"': case '\\': case '/': value += raw[i]; break;
+      case 'b': value += '\b'; break;
+      case 'f': value += '\f'; break;
+      case 'n': value += '\n'; break;
+      case 'r': value += '\r'; break;
+      case 't': value += '\t'; break;
+      case 'u': {
+        unsigned code = 0, low = 0;
+        if (!readHex(i + 1, code)) return false;
+        i += 4;
+        // A character out of the Basic Multilingual Plane is escaped as a surrogate pair
+        if (code >= 0xD800 && code < 0xDC00 && raw.substr(i + 1, 2) == "\\u" && readHex(i + 3, low) && low >= 0xDC00 && low < 0xE000) {
+          code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+          i += 6;
+        }
+        char utf8[4];
+        char *end = utf8;
+        if (!ConvertCodePointToUTF8(code, end)) return false;
+        value.append(utf8, end);
+        break;
+      }
+      default: return false;
+    }
+  }
+  return true;
+}
+
+bool decodeJSONStrings(StringRef raw, std::vector<std::string> &values) {
+  size_t pos = 1;
+  if (raw.empty() || raw.front() != '[') return false;
+  skipWhitespace(raw, pos);
+  if (pos < raw.size() && raw[pos] == ']') return true;
+  for (std::string value;;) {
+    size_t begin = pos;
+    if (pos >= raw.size() || raw[pos] != '"' || !skipJSONValue(raw, pos) || !decodeJSONString(raw.slice(begin, pos), value)) return false;
+    values.push_back(value);
+    skipWhitespace(raw, pos);
+    if (pos >= raw.size() || raw[pos] != ',') return pos < raw.size() && raw[pos] == ']';
+    ++pos;
+    skipWhitespace(raw, pos);
+  }
+}
+
+// The raw JSON values of the fields of a compilation database entry, which are decoded on demand.
+struct CompileCommandFields {
+  StringRef directory;
+  StringRef file;
+  StringRef command;
+  StringRef arguments;
+};
+
+bool parseCompileCommand(StringRef text, CompileCommandFields &fields) {
+  size_t pos = 0;
+  skipWhitespace(text, pos);
+  if (pos >= text.size() || text[pos] != '{') return false;
+  ++pos;
+  skipWhitespace(text, pos);
+  if (pos < text.size() && text[pos] == '}') return true;
+  for (;;) {
+    size_t keyBegin = pos;
+    if (pos >= text.size() || text[pos] != '"' || !skipJSONValue(text, pos)) return false;
+    // The keys of a compilation database are plain identifiers, so they are compared undecoded.
+    StringRef key = text.slice(keyBegin + 1, pos - 1);
+    skipWhitespace(text, pos);
+    if (pos >= text.size() || text[pos] != ':') return false;
+    ++pos;
+    skipWhitespace(text, pos);
+    size_t valueBegin = pos;
+    if (!skipJSONValue(text, pos)) return false;
+    StringRef value = text.slice(valueBegin, pos);
+    if (key == "directory") fields.directory = value;
+    else if (key == "file") fields.file = value;
+    else if (key == "command") fields.command = value;
+    else if (key == "arguments") fields.arguments = value;
+    skipWhitespace(text, pos);
+    if (pos >= text.size() || text[pos] != ',') return pos < text.size() && text[pos] == '}';
+    ++pos;
+    skipWhitespace(text, pos);
+  }
+}
+
+// Push the file of the entry with its compile command, unless the file is filtered out or already pushed.
+bool pushCompileCommand(StringRef text, Regex *include, Regex *exclude, const StringSet<> *selected, StringSet<> &files,
+  SourceQueue &queue) {
+  CompileCommandFields fields;
+  std::string directory, file;
+  if (!parseCompileCommand(text, fields) || !decodeJSONString(fields.directory, directory) || !decodeJSONString(fields.file, file))
+    return false;
+  SmallString<256> path(directory);
+  sys::path::append(path, file);
+  if (sys::path::is_absolute(file)) path = file;
+  sys::path::remove_dots(path, true);
+  // The compile commands of the filtered out entries are never decoded.
+  if ((include && !include->match(path)) || (exclude && exclude->match(path)) || (selected && !selected->count(path)) ||
+      !files.insert(path).second)
+    return true;
+  std::vector<std::string> commandLine;
+  if (!fields.arguments.empty()) {
+    if (!decodeJSONStrings(fields.arguments, commandLine)) return false;
+  } else {
+    std::string command;
+    if (!decodeJSONString(fields.command, command)) return false;
+    BumpPtrAllocator alloc;
+    StringSaver saver(alloc);
+    SmallVector<const char *, 64> argv;
+#if defined(_WIN32)
+    cl::TokenizeWindowsCommandLine(command, saver, argv);
+#else
+    cl::TokenizeGNUCommandLine(command, saver, argv);
+#endif
+    commandLine.assign(argv.begin(), argv.end());
+  }
+  Source source{path.str().str(), "", "", directory, {}};
+  // The compiler and the source file are dropped, as the file, which is worked on, is passed by hipify-clang.
+  for (size_t i = 1; i < commandLine.size(); ++i) {
+    if (commandLine[i] != file && commandLine[i] != source.path)
+      source.arguments.push_back(std::move(commandLine[i]));
+  }
+  queue.push(std::move(source));
+  return true;
+}
+
+} // namespace
+
+void readCompilationDatabase(const std::string &fileName, const std::string &includeRegex,
+  const std::string &excludeRegex, const std::vector<std::string> &selectedFiles, SourceQueue &queue) {
+  std::ifstream file(fileName, std::ios_base::binary);
+  if (!file) {
+    queue.push({fileName, "", std::string(std::strerror(errno)) + ": compilation database: " + fileName});
+    return;
+  }
+  Regex include(includeRegex), exclude(excludeRegex);
+  StringSet<> files, selected;
+  std::vector<std::string> selectedPaths;
+  for (const auto &selectedFile : selectedFiles) {
+    SmallString<256> path(selectedFile);
+    sys::fs::make_absolute(path);
+    sys::path::remove_dots(path, true);
+    if (selected.insert(path).second) selectedPaths.push_back(path.str().str());
+  }
+  // The database is read in chunks, and the text of each entry is collected until its closing brace and then
+  // pushed, so that neither the whole database nor its filtered out entries are kept in memory.
+  std::vector<char> chunk(1 << 20);
+  std::string entry;
+  // The nesting depth: 1 - in the array of the entries, 2 and more - in an entry
+  unsigned depth = 0;
+  bool bInString = false, bEscaped = false, bMalformed = false, bFinished = false;
+  while (!bMalformed && !bFinished && (file.read(chunk.data(), chunk.size()) || file.gcount() > 0)) {
+    StringRef text(chunk.data(), size_t(file.gcount()));
+    size_t entryBegin = 0;
+    for (size_t i = 0; i < text.size() && !bMalformed && !bFinished; ++i) {
+      char c = text[i];
+      if (bInString) {
+        if (bEscaped) bEscaped = false;
+        else if (c == '\\') bEscaped = true;
+        else if (c == '"') bInString = false;
+        continue;
+      }
+      if (isspace(static_cast<unsigned char>(c))) continue;
+      if (depth == 0) {
+        bMalformed = c != '[';
+        depth = 1;
+      } else if (depth == 1) {
+        if (c == ']') {
+          bFinished = true;
+        } else if (c == '{') {
+          depth = 2;
+          entryBegin = i;
+          entry.clear();
+        } else {
+          bMalformed = c != ',';
+        }
+      } else if (c == '"') {
+        bInString = true;
+      } else if (c == '{' || c == '[') {
+        ++depth;
+      } else if ((c == '}' || c == ']') && --depth == 1) {
+        entry.append(text.data() + entryBegin, i + 1 - entryBegin);
+        bMalformed = !pushCompileCommand(entry, includeRegex.empty() ? nullptr : &include,
+          excludeRegex.empty() ? nullptr : &exclude, selected.empty() ? nullptr : &selected, files, queue);
+      }
+    }
+    // The rest of the chunk is the beginning of an entry, which is continued in the next chunk.
+    if (depth > 1) entry.append(text.data() + entryBegin, text.size() - entryBegin);
+  }
+  if (file.bad())
+    queue.push({fileName, "", "reading failed: compilation database: " + fileName});
+  else if (bMalformed || !bFinished)
+    queue.push({fileName, "", "malformed JSON: compilation database: " + fileName});
+  else {
+    for (const auto &path : selectedPaths) {
+      if (!files.count(path))
+        queue.push({path, "", "source file: " + path + " isn't found in compilation database: " + fileName});
+    }
+  }
+}
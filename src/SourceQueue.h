@@ -0,0 +1,101 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Source {
+  std::string path;
+  // The path relative to the walked directory (-dir), mirrored under the output directory; empty for the other sources
+  std::string relativePath;
+  // An error of the producer, which is reported by the consumer instead of hipifying a file
+  std::string error;
+  // The working directory of the compile command of the compilation database (-p); empty for the other sources
+  std::string directory;
+  // The arguments of the compile command without the compiler and the source file
+  std::vector<std::string> arguments;
+};
+
+/**
+  * A queue of the source files to hipify. The producers (e.g., the directory walker) run in separate threads,
+  * so that the files are hipified as they are found, without collecting the whole list first.
+  */
+class SourceQueue {
+public:
+  ~SourceQueue();
+  void push(Source source);
+  /**
+    * Run the producer in a separate thread; the queue is finished once all the producers return.
+    */
+  void produce(std::function<void(SourceQueue &)> producer);
+  /**
+    * Wait for the next source; returns false if the queue is empty and finished.
+    */
+  bool pop(Source &source);
+  /**
+    * Wait for all the producers to return, so that the process has no other threads, e.g., to fork.
+    */
+  void join();
+
+private:
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<Source> sources;
+  std::vector<std::thread> producers;
+  unsigned running = 0;
+};
+
+/**
+  * The default extensions of the source files found by walking a directory, the same as of bin/findcode.sh.
+  */
+extern const std::vector<std::string> defaultSourceExtensions;
+
+/**
+  * Walk the directory tree once, pushing the regular files with any of the (case-insensitive) `extensions`
+  * into the queue; the files and directories matching any of the `ignorePatterns` are skipped.
+  */
+void walkSourceDirectory(const std::string &dir, const std::vector<std::string> &extensions,
+  const std::vector<std::string> &ignorePatterns, SourceQueue &queue);
+
+/**
+  * Read the list of the source files from the file ("-" for stdin) and push them into the queue as they are read.
+  * The paths are separated by newlines or, if a NUL character is read before the first newline, by NULs.
+  */
+void readSourceList(const std::string &fileName, SourceQueue &queue);
+
+/**
+  * Stream the compilation database (compile_commands.json) and push its files with their compile commands into
+  * the queue as they are read, so that the first files are hipified while the rest of the database is still being read.
+  * The entries, which files' absolute paths don't match `includeRegex` or match `excludeRegex` (if not empty), are
+  * skipped without decoding their compile commands; a file of several entries is pushed once, with the first command.
+  * If `selectedFiles` is not empty, only these files are pushed, and each of them not found in the database is an error.
+  */
+void readCompilationDatabase(const std::string &fileName, const std::string &includeRegex,
+  const std::string &excludeRegex, const std::vector<std::string> &selectedFiles, SourceQueue &queue);
@@ -25,7 +25,13 @@ THE SOFTWARE.
 #include <sstream>
 #include <iomanip>
 #include <cmath>
-#include "ArgParse.h"
+#include <algorithm>
+#include <tuple>
+#include "Options.h"
+#include "TextScanner.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/FileSystem.h"
 
 const char *counterNames[NUM_CONV_TYPES] = {
   "error", // CONV_ERROR
@@ -83,6 +89,7 @@ const char *counterTypes[NUM_CONV_TYPES] = {
   "CONV_DEVICE",
   "CONV_CONTEXT",
   "CONV_MODULE",
+  "CONV_LIBRARY",
   "CONV_MEMORY",
   "CONV_VIRTUAL_MEMORY",
   "CONV_STREAM_ORDERED_MEMORY",
@@ -96,6 +103,7 @@ const char *counterTypes[NUM_CONV_TYPES] = {
   "CONV_OCCUPANCY",
   "CONV_TEXTURE",
   "CONV_SURFACE",
+  "CONV_TENSOR",
   "CONV_PEER",
   "CONV_GRAPHICS",
   "CONV_INTERACTION",
@@ -110,6 +118,8 @@ const char *counterTypes[NUM_CONV_TYPES] = {
   "CONV_COMPLEX",
   "CONV_LIB_FUNC",
   "CONV_LIB_DEVICE_FUNC",
+  "CONV_DEVICE_FUNC",
+  "CONV_DEVICE_TYPE",
   "CONV_INCLUDE",
   "CONV_INCLUDE_CUDA_MAIN_H",
   "CONV_INCLUDE_CUDA_MAIN_V2_H",
@@ -143,12 +153,35 @@ const char *apiTypes[NUM_API_TYPES] = {
   "API_RAND",
   "API_DNN",
   "API_FFT",
-  "API_CUB",
   "API_SPARSE",
+  "API_CUB",
   "API_CAFFE2",
   "API_RTC"
 };
 
+const char *perfCounterNames[NUM_PERF_COUNTERS] = {
+  "tokens lexed", // PERF_TOKENS_LEXED
+  "rename lookups", // PERF_RENAME_LOOKUPS
+  "string literals scanned", // PERF_STRING_LITERALS
+  "replacements inserted", // PERF_REPLACEMENTS_INSERTED
+  "replacements rejected" // PERF_REPLACEMENTS_REJECTED
+};
+
+const char *matcherNames[NUM_MATCHERS] = {
+  "cudaLaunchKernel", // MATCHER_CUDA_LAUNCH_KERNEL
+  "cudaHostFuncCall", // MATCHER_CUDA_HOST_FUNC_CALL
+  "cudaDeviceFuncCall", // MATCHER_CUDA_DEVICE_FUNC_CALL
+  "cubNamespacePrefix", // MATCHER_CUB_NAMESPACE_PREFIX
+  "cubFunctionTemplateDecl", // MATCHER_CUB_FUNCTION_TEMPLATE_DECL
+  "cubUsingNamespaceDecl" // MATCHER_CUB_USING_NAMESPACE_DECL
+};
+
+const char *phaseNames[NUM_PHASES] = {
+  "prepare", // PHASE_PREPARE
+  "hipify", // PHASE_HIPIFY
+  "output" // PHASE_OUTPUT
+};
+
 namespace {
 
 template<typename ST, typename ST2>
@@ -169,17 +202,97 @@ void printStat(std::ostream *csv, llvm::raw_ostream *printOut, const std::string
     *csv << name << ";" << value << "\n";
 }
 
+// Quote and escape a string for JSON output.
+std::string jsonString(const std::string &s) {
+  std::string res = "\"";
+  for (const char c : s) {
+    switch (c) {
+      case '"':  res += "\\\""; break;
+      case '\\': res += "\\\\"; break;
+      case '\n': res += "\\n"; break;
+      case '\r': res += "\\r"; break;
+      case '\t': res += "\\t"; break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          std::stringstream stream;
+          stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c;
+          res += stream.str();
+        } else {
+          res += c;
+        }
+    }
+  }
+  return res + "\"";
+}
+
+// Quote and escape a string for an OpenMetrics label value.
+std::string metricsLabel(const std::string &s) {
+  std::string res = "\"";
+  for (const char c : s) {
+    switch (c) {
+      case '"':  res += "\\\""; break;
+      case '\\': res += "\\\\"; break;
+      case '\n': res += "\\n"; break;
+      default: res += c;
+    }
+  }
+  return res + "\"";
+}
+
+// Write the metric family header.
+void printMetricHeader(std::ostream &metrics, const std::string &name, const std::string &type, const std::string &help) {
+  metrics << "# TYPE " << name << " " << type << "\n";
+  metrics << "# HELP " << name << " " << help << "\n";
+}
+
+// Make a JSON key from a human-readable name.
+std::string jsonKey(std::string name) {
+  std::replace(name.begin(), name.end(), ' ', '_');
+  return jsonString(name);
+}
+
 } // Anonymous namespace
 
-void StatCounter::incrementCounter(const hipCounter &counter, const std::string &name) {
-  counters[name]++;
+unsigned StatNames::getID(llvm::StringRef name) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto res = ids.insert(std::make_pair(name, unsigned(names.size())));
+  if (res.second) {
+    names.push_back(res.first->getKey());
+  }
+  return res.first->getValue();
+}
+
+llvm::StringRef StatNames::getName(unsigned id) {
+  std::lock_guard<std::mutex> lock(mutex);
+  assert(id < names.size());
+  return names[id];
+}
+
+void StatCounter::incrementNamed(unsigned id, int value) {
+  if (id >= counters.size()) {
+    counters.resize(id + 1, 0);
+  }
+  if (counters[id] == 0) {
+    countedNames.push_back(id);
+  }
+  counters[id] += value;
+}
+
+std::vector<unsigned> StatCounter::getSortedNames() const {
+  std::vector<unsigned> sorted(countedNames);
+  std::sort(sorted.begin(), sorted.end(), [](unsigned a, unsigned b) { return StatNames::getName(a) < StatNames::getName(b); });
+  return sorted;
+}
+
+void StatCounter::incrementCounter(const hipCounter &counter, llvm::StringRef name) {
+  incrementNamed(StatNames::getID(name), 1);
   apiCounters[(int) counter.apiType]++;
   convTypeCounters[(int) counter.type]++;
 }
 
 void StatCounter::add(const StatCounter &other) {
-  for (const auto &p : other.counters)
-    counters[p.first] += p.second;
+  for (const unsigned id : other.countedNames)
+    incrementNamed(id, other.counters[id]);
   for (int i = 0; i < NUM_API_TYPES; ++i)
     apiCounters[i] += other.apiCounters[i];
   for (int i = 0; i < NUM_CONV_TYPES; ++i)
@@ -216,61 +329,217 @@ void StatCounter::print(std::ostream *csv, llvm::raw_ostream *printOut, const st
       printStat(csv, printOut, apiNames[i], apiCounters[i]);
     }
   }
-  if (counters.size() > 0) {
+  if (countedNames.size() > 0) {
     conditionalPrint(csv, printOut, "\nCUDA ref name;Count\n", "[HIPIFY] info: " + prefix + " refs by names:\n");
-    for (const auto &it : counters) {
-      printStat(csv, printOut, it.first, it.second);
+    for (const unsigned id : getSortedNames()) {
+      printStat(csv, printOut, StatNames::getName(id).str(), counters[id]);
     }
   }
 }
 
-Statistics::Statistics(const std::string &name): fileName(name) {
-  // Compute the total bytes/lines in the input file.
-  std::ifstream src_file(name, std::ios::binary | std::ios::ate);
-  if (src_file.good()) {
-    src_file.clear();
-    src_file.seekg(0);
-    totalLines = (unsigned)std::count(std::istreambuf_iterator<char>(src_file), std::istreambuf_iterator<char>(), '\n');
-    totalBytes = (unsigned)src_file.tellg();
-    if (totalBytes < 0) {
-      totalBytes = 0;
+void StatCounter::printJSON(std::ostream &json) {
+  json << "{\"by_type\":{";
+  bool first = true;
+  for (int i = 0; i < NUM_CONV_TYPES; ++i) {
+    if (convTypeCounters[i] > 0) {
+      json << (first ? "" : ",") << jsonString(counterNames[i]) << ":" << convTypeCounters[i];
+      first = false;
+    }
+  }
+  json << "},\"by_api\":{";
+  first = true;
+  for (int i = 0; i < NUM_API_TYPES; ++i) {
+    if (apiCounters[i] > 0) {
+      json << (first ? "" : ",") << jsonString(apiNames[i]) << ":" << apiCounters[i];
+      first = false;
     }
   }
+  json << "},\"by_name\":{";
+  first = true;
+  for (const unsigned id : getSortedNames()) {
+    json << (first ? "" : ",") << jsonString(StatNames::getName(id).str()) << ":" << counters[id];
+    first = false;
+  }
+  json << "}}";
+}
+
+void StatCounter::serialize(std::ostream &os) const {
+  for (const int c : apiCounters)
+    os << c << " ";
+  for (const int c : convTypeCounters)
+    os << c << " ";
+  // The names are identifiers or include file names, so they don't contain whitespace.
+  os << countedNames.size();
+  for (const unsigned id : countedNames)
+    os << " " << StatNames::getName(id).str() << " " << counters[id];
+  os << "\n";
+}
+
+bool StatCounter::deserialize(std::istream &is) {
+  for (int &c : apiCounters)
+    is >> c;
+  for (int &c : convTypeCounters)
+    is >> c;
+  size_t count = 0;
+  is >> count;
+  for (size_t i = 0; i < count && is; ++i) {
+    std::string name;
+    int value = 0;
+    if (is >> name >> value) {
+      incrementNamed(StatNames::getID(name), value);
+    }
+  }
+  return bool(is);
+}
+
+void PerfCounters::add(const PerfCounters &other) {
+  for (int i = 0; i < NUM_PERF_COUNTERS; ++i)
+    counters[i] += other.counters[i];
+  for (int i = 0; i < NUM_API_TYPES; ++i)
+    apiHits[i] += other.apiHits[i];
+  for (int i = 0; i < NUM_MATCHERS; ++i)
+    matcherCallbacks[i] += other.matcherCallbacks[i];
+}
+
+void PerfCounters::print(std::ostream *csv, llvm::raw_ostream *printOut) {
+  conditionalPrint(csv, printOut, "Perf counter;Count\n", "");
+  for (int i = 0; i < NUM_PERF_COUNTERS; ++i)
+    printStat(csv, printOut, perfCounterNames[i], counters[i]);
+  unsigned long long hits = 0;
+  for (int i = 0; i < NUM_API_TYPES; ++i)
+    hits += apiHits[i];
+  std::stringstream stream;
+  stream << std::fixed << std::setprecision(1) << (0 == counters[PERF_RENAME_LOOKUPS] ? 0 : double(hits) / double(counters[PERF_RENAME_LOOKUPS]) * 100);
+  printStat(csv, printOut, "rename hit rate %", stream.str());
+  conditionalPrint(csv, printOut, "\nRename hits by API;Count\n", "[HIPIFY] info: rename hits by API:\n");
+  for (int i = 0; i < NUM_API_TYPES; ++i)
+    if (apiHits[i] > 0)
+      printStat(csv, printOut, apiNames[i], apiHits[i]);
+  conditionalPrint(csv, printOut, "\nMatcher callbacks;Count\n", "[HIPIFY] info: matcher callbacks:\n");
+  for (int i = 0; i < NUM_MATCHERS; ++i)
+    printStat(csv, printOut, matcherNames[i], matcherCallbacks[i]);
+}
+
+void PerfCounters::serialize(std::ostream &os) const {
+  for (const unsigned long long c : counters)
+    os << c << " ";
+  for (const unsigned long long c : apiHits)
+    os << c << " ";
+  for (const unsigned long long c : matcherCallbacks)
+    os << c << " ";
+  os << "\n";
+}
+
+bool PerfCounters::deserialize(std::istream &is) {
+  for (unsigned long long &c : counters)
+    is >> c;
+  for (unsigned long long &c : apiHits)
+    is >> c;
+  for (unsigned long long &c : matcherCallbacks)
+    is >> c;
+  return bool(is);
+}
+
+void PerfCounters::printJSON(std::ostream &json) {
+  json << "{";
+  for (int i = 0; i < NUM_PERF_COUNTERS; ++i)
+    json << (i ? "," : "") << jsonKey(perfCounterNames[i]) << ":" << counters[i];
+  json << ",\"rename_hits_by_api\":{";
+  bool first = true;
+  for (int i = 0; i < NUM_API_TYPES; ++i) {
+    if (apiHits[i] > 0) {
+      json << (first ? "" : ",") << jsonString(apiNames[i]) << ":" << apiHits[i];
+      first = false;
+    }
+  }
+  json << "},\"matcher_callbacks\":{";
+  for (int i = 0; i < NUM_MATCHERS; ++i)
+    json << (i ? "," : "") << jsonString(matcherNames[i]) << ":" << matcherCallbacks[i];
+  json << "}}";
+}
+
+Statistics::Statistics(const std::string &name): fileName(name) {
   startTime = chr::steady_clock::now();
 }
 
 ///////// Counter update routines //////////
 
-void Statistics::incrementCounter(const hipCounter &counter, const std::string &name) {
+void Statistics::incrementCounter(const hipCounter &counter, llvm::StringRef name) {
   if (Statistics::isUnsupported(counter)) {
     unsupported.incrementCounter(counter, name);
   } else {
     supported.incrementCounter(counter, name);
   }
+  if (Statistics::isRemovedInTarget(counter)) {
+    removedInTarget.incrementCounter(counter, name);
+  }
 }
 
 void Statistics::add(const Statistics &other) {
   supported.add(other.supported);
   unsupported.add(other.unsupported);
+  removedInTarget.add(other.removedInTarget);
   touchedBytes += other.touchedBytes;
   totalBytes += other.totalBytes;
   touchedLines += other.touchedLines;
   totalLines += other.totalLines;
+  sourceCounted = true;
+  perf.add(other.perf);
+  for (int i = 0; i < NUM_PHASES; ++i)
+    phaseDurations[i] += other.phaseDurations[i];
   if (other.hasErrors && !hasErrors) hasErrors = true;
   if (startTime > other.startTime)   startTime = other.startTime;
 }
 
+void Statistics::serialize(std::ostream &os) const {
+  os << hasErrors << " " << sourceCounted << " " << touchedLines << " " << totalLines << " " << touchedBytes << " " << totalBytes << "\n";
+  supported.serialize(os);
+  unsupported.serialize(os);
+  removedInTarget.serialize(os);
+  perf.serialize(os);
+}
+
+bool Statistics::deserialize(std::istream &is) {
+  is >> hasErrors >> sourceCounted >> touchedLines >> totalLines >> touchedBytes >> totalBytes;
+  return is && supported.deserialize(is) && unsupported.deserialize(is) && removedInTarget.deserialize(is) && perf.deserialize(is);
+}
+
+void Statistics::setSource(llvm::StringRef source) {
+  totalBytes = unsigned(source.size());
+  totalLines = unsigned(countNewLines(source));
+  // Line numbers are 1-based; the last line might be not terminated by '\n'.
+  touchedLinesBitmap.resize(totalLines + 2);
+  sourceCounted = true;
+}
+
 void Statistics::lineTouched(unsigned int lineNumber) {
-  touchedLinesSet.insert(lineNumber);
-  touchedLines = unsigned(touchedLinesSet.size());
+  if (lineNumber >= touchedLinesBitmap.size()) {
+    touchedLinesBitmap.resize(lineNumber + 1);
+  }
+  if (!touchedLinesBitmap.test(lineNumber)) {
+    touchedLinesBitmap.set(lineNumber);
+    touchedLines++;
+  }
 }
 
 void Statistics::bytesChanged(unsigned int bytes) {
   touchedBytes += bytes;
 }
 
+void Statistics::addPhaseDuration(StatPhases phase, chr::steady_clock::duration duration) {
+  phaseDurations[phase] += duration;
+}
+
 void Statistics::markCompletion() {
   completionTime = chr::steady_clock::now();
+  if (!sourceCounted) {
+    // The file hasn't reached hipification, so read it once, memory-mapped if possible.
+    auto buffer = llvm::MemoryBuffer::getFile(fileName);
+    if (buffer) {
+      setSource((*buffer)->getBuffer());
+    }
+    sourceCounted = true;
+  }
 }
 
 ///////// Output functions //////////
@@ -281,7 +550,10 @@ void Statistics::print(std::ostream *csv, llvm::raw_ostream *printOut, bool skip
     conditionalPrint(csv, printOut, "\n" + str, "\n[HIPIFY] info: " + str);
   }
   if (hasErrors || totalBytes == 0 || totalLines == 0) {
-    std::string str = "\n  ERROR: Statistics is invalid due to failed hipification.\n\n";
+    std::string str = timedOut ? "\n  ERROR: Statistics is invalid due to hipification timeout.\n\n" : "\n  ERROR: Statistics is invalid due to failed hipification.\n\n";
+    conditionalPrint(csv, printOut, str, str);
+  } else if (timedOut) {
+    std::string str = "\n  WARNING: hipified by the lexical engine due to hipification timeout.\n\n";
     conditionalPrint(csv, printOut, str, str);
   }
   std::stringstream stream;
@@ -291,6 +563,10 @@ void Statistics::print(std::ostream *csv, llvm::raw_ostream *printOut, bool skip
   int allSum = supportedSum + unsupportedSum;
   printStat(csv, printOut, "CONVERTED refs count", supportedSum);
   printStat(csv, printOut, "UNCONVERTED refs count", unsupportedSum);
+  int removedInTargetSum = removedInTarget.getConvSum();
+  if (removedInTargetSum > 0) {
+    printStat(csv, printOut, "REMOVED IN TARGET refs count", removedInTargetSum);
+  }
   stream << std::fixed << std::setprecision(1) << 100 - (0 == allSum ? 100 : double(unsupportedSum) / double(allSum) * 100);
   printStat(csv, printOut, "CONVERSION %", stream.str());
   stream.str("");
@@ -310,34 +586,170 @@ void Statistics::print(std::ostream *csv, llvm::raw_ostream *printOut, bool skip
   printStat(csv, printOut, "TIME ELAPSED s", stream.str());
   supported.print(csv, printOut, "CONVERTED");
   unsupported.print(csv, printOut, "UNCONVERTED");
+  removedInTarget.print(csv, printOut, "REMOVED IN TARGET");
+}
+
+void Statistics::printJSONFields(std::ostream &json, bool bPerf) {
+  int supportedSum = supported.getConvSum();
+  int unsupportedSum = unsupported.getConvSum();
+  int allSum = supportedSum + unsupportedSum;
+  bool invalid = hasErrors || totalBytes == 0 || totalLines == 0;
+  typedef std::chrono::duration<double, std::milli> duration;
+  duration elapsed = completionTime - startTime;
+  json << "\"file\":" << jsonString(fileName);
+  json << ",\"status\":" << (timedOut ? (invalid ? "\"timeout\"" : "\"timeout_lexical\"") : (invalid ? "\"failed\"" : "\"ok\""));
+  json << ",\"converted_refs\":" << supportedSum;
+  json << ",\"unconverted_refs\":" << unsupportedSum;
+  json << ",\"removed_in_target_refs\":" << removedInTarget.getConvSum();
+  json << std::fixed << std::setprecision(1);
+  json << ",\"conversion_percent\":" << 100 - (0 == allSum ? 100 : double(unsupportedSum) / double(allSum) * 100);
+  json << ",\"replaced_bytes\":" << touchedBytes;
+  json << ",\"total_bytes\":" << totalBytes;
+  json << ",\"changed_lines\":" << touchedLines;
+  json << ",\"total_lines\":" << totalLines;
+  json << std::setprecision(3);
+  json << ",\"time_elapsed_s\":" << elapsed.count() / 1000;
+  json << ",\"converted\":";
+  supported.printJSON(json);
+  json << ",\"unconverted\":";
+  unsupported.printJSON(json);
+  json << ",\"removed_in_target\":";
+  removedInTarget.printJSON(json);
+  json.unsetf(std::ios_base::floatfield);
+  if (bPerf) {
+    json << ",\"perf\":";
+    perf.printJSON(json);
+  }
+}
+
+void Statistics::printJSON(std::ostream *jsonl, bool bPerf) {
+  if (!jsonl) {
+    return;
+  }
+  *jsonl << "{";
+  printJSONFields(*jsonl, bPerf);
+  *jsonl << "}" << std::endl;
 }
 
 void Statistics::printAggregate(std::ostream *csv, llvm::raw_ostream *printOut) {
   Statistics globalStats = getAggregate();
-  // A file is considered "converted" if we made any changes to it.
-  int convertedFiles = 0;
-  for (const auto &p : stats) {
-    if (p.second.touchedLines && p.second.totalBytes &&
-        p.second.totalLines && !p.second.hasErrors) {
-      convertedFiles++;
-    }
-  }
   globalStats.markCompletion();
   globalStats.print(csv, printOut);
   std::string str = "TOTAL statistics:";
   conditionalPrint(csv, printOut, "\n" + str + "\n", "\n[HIPIFY] info: " + str + "\n");
   printStat(csv, printOut, "CONVERTED files", convertedFiles);
-  printStat(csv, printOut, "PROCESSED files", stats.size());
+  printStat(csv, printOut, "PROCESSED files", processedFiles);
+  if (timedOutFiles) {
+    printStat(csv, printOut, "TIMED OUT files", timedOutFiles);
+  }
+}
+
+void Statistics::printPerfCounters(std::ostream *csv, llvm::raw_ostream *printOut) {
+  std::string str = "file \'" + fileName + "\' ";
+  conditionalPrint(csv, printOut, "\n" + str + "perf counters:\n", "\n[HIPIFY] info: " + str + "perf counters:\n");
+  perf.print(csv, printOut);
+}
+
+void Statistics::printAggregatePerfCounters(std::ostream *csv, llvm::raw_ostream *printOut) {
+  Statistics globalStats = getAggregate();
+  std::string str = "TOTAL perf counters:";
+  conditionalPrint(csv, printOut, "\n" + str + "\n", "\n[HIPIFY] info: " + str + "\n");
+  globalStats.perf.print(csv, printOut);
+}
+
+bool Statistics::writeMetrics(const std::string &fileName) {
+  Statistics globalStats = getAggregate();
+  globalStats.markCompletion();
+  typedef std::chrono::duration<double> seconds;
+  double elapsed = seconds(globalStats.completionTime - globalStats.startTime).count();
+  // Write into a temporary file next to the target one, so that a collector never reads a partial file.
+  std::string tmpFileName = fileName + ".tmp";
+  {
+    std::ofstream metrics(tmpFileName, std::ios_base::trunc);
+    if (!metrics.good()) {
+      return false;
+    }
+    metrics << std::fixed << std::setprecision(6);
+    printMetricHeader(metrics, "hipify_files_processed", "counter", "Source files processed.");
+    metrics << "hipify_files_processed_total " << processedFiles << "\n";
+    printMetricHeader(metrics, "hipify_files_failed", "counter", "Source files failed to be hipified.");
+    metrics << "hipify_files_failed_total " << failedFiles << "\n";
+    printMetricHeader(metrics, "hipify_files_timed_out", "counter", "Source files, which hipification timed out on.");
+    metrics << "hipify_files_timed_out_total " << timedOutFiles << "\n";
+    printMetricHeader(metrics, "hipify_files_converted", "counter", "Source files hipified with at least one change.");
+    metrics << "hipify_files_converted_total " << convertedFiles << "\n";
+    printMetricHeader(metrics, "hipify_refs_converted", "counter", "Converted CUDA references by API.");
+    for (int i = 0; i < NUM_API_TYPES; ++i)
+      metrics << "hipify_refs_converted_total{api=" << metricsLabel(apiNames[i]) << "} " << globalStats.supported.getApiCounter(ApiTypes(i)) << "\n";
+    printMetricHeader(metrics, "hipify_refs_unconverted", "counter", "Unconverted CUDA references by API.");
+    for (int i = 0; i < NUM_API_TYPES; ++i)
+      metrics << "hipify_refs_unconverted_total{api=" << metricsLabel(apiNames[i]) << "} " << globalStats.unsupported.getApiCounter(ApiTypes(i)) << "\n";
+    printMetricHeader(metrics, "hipify_bytes_changed", "counter", "Bytes replaced in the source files.");
+    metrics << "hipify_bytes_changed_total " << globalStats.touchedBytes << "\n";
+    printMetricHeader(metrics, "hipify_bytes_processed", "counter", "Bytes of the processed source files.");
+    metrics << "hipify_bytes_processed_total " << globalStats.totalBytes << "\n";
+    printMetricHeader(metrics, "hipify_phase_duration_seconds", "counter", "Cumulative durations of the processing phases.");
+    for (int i = 0; i < NUM_PHASES; ++i)
+      metrics << "hipify_phase_duration_seconds_total{phase=" << metricsLabel(phaseNames[i]) << "} " << seconds(globalStats.phaseDurations[i]).count() << "\n";
+    printMetricHeader(metrics, "hipify_throughput_files_per_second", "gauge", "Processed source files per second.");
+    metrics << "hipify_throughput_files_per_second " << (elapsed > 0 ? processedFiles / elapsed : 0) << "\n";
+    printMetricHeader(metrics, "hipify_throughput_megabytes_per_second", "gauge", "Processed megabytes of source files per second.");
+    metrics << "hipify_throughput_megabytes_per_second " << (elapsed > 0 ? globalStats.totalBytes / 1e6 / elapsed : 0) << "\n";
+    metrics << "# EOF\n";
+    if (!metrics.good()) {
+      return false;
+    }
+  }
+  return !llvm::sys::fs::rename(tmpFileName, fileName);
+}
+
+void Statistics::printAggregateJSON(std::ostream *jsonl, bool bPerf) {
+  if (!jsonl) {
+    return;
+  }
+  Statistics globalStats = getAggregate();
+  globalStats.markCompletion();
+  *jsonl << "{";
+  globalStats.printJSONFields(*jsonl, bPerf);
+  *jsonl << ",\"aggregate\":true";
+  *jsonl << ",\"converted_files\":" << convertedFiles;
+  *jsonl << ",\"processed_files\":" << processedFiles;
+  *jsonl << ",\"timed_out_files\":" << timedOutFiles;
+  *jsonl << "}" << std::endl;
 }
 
 //// Static state management ////
 
+void Statistics::foldCurrent() {
+  if (!currentStatistics) {
+    return;
+  }
+  const Statistics &cur = *currentStatistics;
+  // A file is considered "converted" if we made any changes to it.
+  if (cur.touchedLines && cur.totalBytes && cur.totalLines && !cur.hasErrors) {
+    convertedFiles++;
+  }
+  processedFiles++;
+  if (cur.hasErrors) {
+    failedFiles++;
+  }
+  if (cur.timedOut) {
+    timedOutFiles++;
+  }
+  if (!aggregateStatistics) {
+    aggregateStatistics.reset(new Statistics("GLOBAL"));
+    aggregateStatistics->startTime = cur.startTime;
+  }
+  aggregateStatistics->add(cur);
+  currentStatistics.reset();
+}
+
 Statistics Statistics::getAggregate() {
-  Statistics globalStats("GLOBAL");
-  for (const auto &p : stats) {
-    globalStats.add(p.second);
+  foldCurrent();
+  if (!aggregateStatistics) {
+    return Statistics("GLOBAL");
   }
-  return globalStats;
+  return *aggregateStatistics;
 }
 
 Statistics &Statistics::current() {
@@ -346,8 +758,8 @@ Statistics &Statistics::current() {
 }
 
 void Statistics::setActive(const std::string &name) {
-  stats.emplace(std::make_pair(name, Statistics{name}));
-  Statistics::currentStatistics = &stats.at(name);
+  foldCurrent();
+  Statistics::currentStatistics.reset(new Statistics(name));
 }
 
 bool Statistics::isToRoc(const hipCounter &counter) {
@@ -413,6 +825,10 @@ bool Statistics::isRocMiopenOnly(const hipCounter& counter) {
   return ROC_MIOPEN_ONLY == (counter.supportDegree & ROC_MIOPEN_ONLY);
 }
 
+bool Statistics::isRemovedInTarget(const hipCounter& counter) {
+  return REMOVED_IN_TARGET == (counter.supportDegree & REMOVED_IN_TARGET);
+}
+
 std::string Statistics::getCudaVersion(const cudaVersions& ver) {
   switch (ver) {
     case CUDA_0:
@@ -559,5 +975,33 @@ std::string Statistics::getHipVersion(const hipVersions& ver) {
   return "";
 }
 
-std::map<std::string, Statistics> Statistics::stats = {};
-Statistics *Statistics::currentStatistics = nullptr;
+cudaVersions Statistics::parseCudaVersion(llvm::StringRef ver) {
+  llvm::StringRef sMajor, sMinor;
+  std::tie(sMajor, sMinor) = ver.split('.');
+  unsigned major = 0, minor = 0;
+  if (sMajor.getAsInteger(10, major) || sMinor.getAsInteger(10, minor) || major == 0 || minor > 9) {
+    return CUDA_0;
+  }
+  return cudaVersions(major * 1000 + minor * 10);
+}
+
+hipVersions Statistics::parseHipVersion(llvm::StringRef ver) {
+  llvm::SmallVector<llvm::StringRef, 3> parts;
+  ver.split(parts, '.');
+  unsigned major = 0, minor = 0, patch = 0;
+  if (parts.size() < 2 || parts.size() > 3 || parts[0].getAsInteger(10, major) || parts[1].getAsInteger(10, minor) ||
+      (parts.size() == 3 && parts[2].getAsInteger(10, patch)) || major == 0 || minor > 99 || patch > 9) {
+    return HIP_0;
+  }
+  return hipVersions(major * 1000 + minor * 10 + patch);
+}
+
+llvm::StringMap<unsigned> StatNames::ids;
+std::vector<llvm::StringRef> StatNames::names;
+std::mutex StatNames::mutex;
+thread_local std::unique_ptr<Statistics> Statistics::currentStatistics;
+std::unique_ptr<Statistics> Statistics::aggregateStatistics;
+unsigned Statistics::convertedFiles = 0;
+unsigned Statistics::processedFiles = 0;
+unsigned Statistics::failedFiles = 0;
+unsigned Statistics::timedOutFiles = 0;
@@ -27,7 +27,12 @@ THE SOFTWARE.
 #include <fstream>
 #include <map>
 #include <set>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include <llvm/ADT/StringRef.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/BitVector.h>
 #include <llvm/Support/raw_ostream.h>
 
 namespace chr = std::chrono;
@@ -183,6 +188,38 @@ enum ApiTypes {
 };
 constexpr int NUM_API_TYPES = (int) ApiTypes::API_LAST;
 
+enum PerfCounterTypes {
+  PERF_TOKENS_LEXED = 0,
+  PERF_RENAME_LOOKUPS,
+  PERF_STRING_LITERALS,
+  PERF_REPLACEMENTS_INSERTED,
+  PERF_REPLACEMENTS_REJECTED,
+  PERF_LAST
+};
+constexpr int NUM_PERF_COUNTERS = (int) PerfCounterTypes::PERF_LAST;
+
+enum MatcherTypes {
+  MATCHER_CUDA_LAUNCH_KERNEL = 0,
+  MATCHER_CUDA_HOST_FUNC_CALL,
+  MATCHER_CUDA_DEVICE_FUNC_CALL,
+  MATCHER_CUB_NAMESPACE_PREFIX,
+  MATCHER_CUB_FUNCTION_TEMPLATE_DECL,
+  MATCHER_CUB_USING_NAMESPACE_DECL,
+  MATCHER_LAST
+};
+constexpr int NUM_MATCHERS = (int) MatcherTypes::MATCHER_LAST;
+
+enum StatPhases {
+  // Copying the source file into a temporary one
+  PHASE_PREPARE = 0,
+  // Parsing and rewriting the temporary file
+  PHASE_HIPIFY,
+  // Copying the result into the output file
+  PHASE_OUTPUT,
+  PHASE_LAST
+};
+constexpr int NUM_PHASES = (int) StatPhases::PHASE_LAST;
+
 enum SupportDegree {
   FULL = 0x0,
   HIP_UNSUPPORTED = 0x1,
@@ -196,7 +233,9 @@ enum SupportDegree {
   REMOVED = 0x100,
   HIP_EXPERIMENTAL = 0x200,
   HIP_SUPPORTED_V2_ONLY = 0x400,
-  ROC_MIOPEN_ONLY = 0x800
+  ROC_MIOPEN_ONLY = 0x800,
+  // Removed in the target CUDA or HIP release of --cuda-version, --hip-version
+  REMOVED_IN_TARGET = 0x1000
 };
 
 enum cudaVersions {
@@ -356,6 +395,9 @@ extern const char *counterNames[NUM_CONV_TYPES];
 extern const char *counterTypes[NUM_CONV_TYPES];
 extern const char *apiNames[NUM_API_TYPES];
 extern const char *apiTypes[NUM_API_TYPES];
+extern const char *perfCounterNames[NUM_PERF_COUNTERS];
+extern const char *matcherNames[NUM_MATCHERS];
+extern const char *phaseNames[NUM_PHASES];
 
 struct hipCounter {
   llvm::StringRef hipName;
@@ -366,22 +408,79 @@ struct hipCounter {
   unsigned int supportDegree;
 };
 
+/**
+  * Interns the names of the counted references, so that named counters might be kept in dense arrays
+  * indexed by the name ID instead of string-keyed maps. IDs are shared by all the StatCounters of all the threads.
+  */
+class StatNames {
+private:
+  static llvm::StringMap<unsigned> ids;
+  // The interned names in order of their IDs; the strings are owned by `ids`.
+  static std::vector<llvm::StringRef> names;
+  // Guards `ids` and `names`, as the files might be hipified concurrently by libhipify.
+  static std::mutex mutex;
+
+public:
+  // Get the ID of the name, interning the name if it is met for the first time.
+  static unsigned getID(llvm::StringRef name);
+  static llvm::StringRef getName(unsigned id);
+};
+
 /**
   * Tracks a set of named counters, as well as counters for each of the type enums defined above.
   */
 class StatCounter {
 private:
   // Each thing we track is either "supported" or "unsupported"...
-  std::map<std::string, int> counters;
+  // Named counters indexed by the StatNames ID.
+  std::vector<int> counters;
+  // IDs of the names with non-zero counters.
+  std::vector<unsigned> countedNames;
   int apiCounters[NUM_API_TYPES] = {};
   int convTypeCounters[NUM_CONV_TYPES] = {};
+  // Increment the named counter by `value`.
+  void incrementNamed(unsigned id, int value);
+  // Get IDs of the counted names in the alphabetical order of names.
+  std::vector<unsigned> getSortedNames() const;
 
 public:
-  void incrementCounter(const hipCounter &counter, const std::string &name);
+  void incrementCounter(const hipCounter &counter, llvm::StringRef name);
   // Add the counters from `other` onto the counters of this object.
   void add(const StatCounter &other);
   int getConvSum();
+  int getApiCounter(ApiTypes api) const { return apiCounters[api]; }
   void print(std::ostream* csv, llvm::raw_ostream* printOut, const std::string &prefix);
+  // Write the counters as a JSON object with "by_type", "by_api" and "by_name" members.
+  void printJSON(std::ostream &json);
+  // Write the counters in a compact text form, which is read back by `deserialize`.
+  void serialize(std::ostream &os) const;
+  bool deserialize(std::istream &is);
+};
+
+/**
+  * Tracks the counters of the hipification hot paths. The counters are incremented unconditionally, so
+  * counting is branch-free; they are printed only if requested by the --print-perf-counters option.
+  */
+class PerfCounters {
+private:
+  unsigned long long counters[NUM_PERF_COUNTERS] = {};
+  // Rename lookup hits by the API table.
+  unsigned long long apiHits[NUM_API_TYPES] = {};
+  // Callbacks fired per matcher.
+  unsigned long long matcherCallbacks[NUM_MATCHERS] = {};
+
+public:
+  void count(PerfCounterTypes type) { counters[type]++; }
+  void countHit(ApiTypes api) { apiHits[api]++; }
+  void countMatcher(MatcherTypes matcher) { matcherCallbacks[matcher]++; }
+  // Add the counters from `other` onto the counters of this object.
+  void add(const PerfCounters &other);
+  void print(std::ostream* csv, llvm::raw_ostream* printOut);
+  // Write the counters as a JSON object.
+  void printJSON(std::ostream &json);
+  // Write the counters in a compact text form, which is read back by `deserialize`.
+  void serialize(std::ostream &os) const;
+  bool deserialize(std::istream &is);
 };
 
 /**
@@ -390,24 +489,45 @@ public:
 class Statistics {
   StatCounter supported;
   StatCounter unsupported;
+  // The refs to the APIs removed in the target CUDA or HIP release; they are counted as (un)supported as well.
+  StatCounter removedInTarget;
   std::string fileName;
-  std::set<int> touchedLinesSet = {};
+  // Bitmap of the touched lines indexed by line number.
+  llvm::BitVector touchedLinesBitmap;
+  // Whether totalLines/totalBytes are already computed.
+  bool sourceCounted = false;
   unsigned touchedLines = 0;
   unsigned totalLines = 0;
   unsigned touchedBytes = 0;
   unsigned totalBytes = 0;
   chr::steady_clock::time_point startTime;
   chr::steady_clock::time_point completionTime;
+  // Cumulative durations of the processing phases.
+  chr::steady_clock::duration phaseDurations[NUM_PHASES] = {};
+  // Write the statistics as the comma-separated members of a JSON object.
+  void printJSONFields(std::ostream &json, bool bPerf);
 
 public:
+  // Hot path counters, reported by the --print-perf-counters option.
+  PerfCounters perf;
   Statistics(const std::string &name);
-  void incrementCounter(const hipCounter &counter, const std::string &name);
+  void incrementCounter(const hipCounter &counter, llvm::StringRef name);
   // Add the counters from `other` onto the counters of this object.
   void add(const Statistics &other);
+  // Compute the total bytes/lines from the source buffer, which is already loaded for hipification.
+  void setSource(llvm::StringRef source);
   void lineTouched(unsigned int lineNumber);
   void bytesChanged(unsigned int bytes);
-  // Set the completion timestamp to now.
+  void addPhaseDuration(StatPhases phase, chr::steady_clock::duration duration);
+  // Set the completion timestamp to now; compute the total bytes/lines if they are not computed yet.
   void markCompletion();
+  /**
+    * Write the counters, collected by hipification, in a compact text form, so that the statistics of a file
+    * hipified in a worker process might be passed back; the phase durations are measured by the caller.
+    */
+  void serialize(std::ostream &os) const;
+  // Read the counters written by `serialize`; returns false on malformed data.
+  bool deserialize(std::istream &is);
 
 public:
   /**
@@ -418,23 +538,58 @@ public:
     *                 such stats are produced.
     */
   void print(std::ostream* csv, llvm::raw_ostream* printOut, bool skipHeader = false);
+  /**
+    * Write the statistics stored in this object as a single JSON Lines record and flush the stream,
+    * so that consumers may process the record as soon as the file is hipified.
+    *
+    * @param jsonl Pointer to an output stream for the JSON Lines to write. If null, nothing is written
+    * @param bPerf Whether to write the hot path counters
+    */
+  void printJSON(std::ostream* jsonl, bool bPerf = false);
+  // Print the hot path counters stored in this object.
+  void printPerfCounters(std::ostream* csv, llvm::raw_ostream* printOut);
   // Print aggregated statistics for all registered counters.
   static void printAggregate(std::ostream *csv, llvm::raw_ostream* printOut);
-  // The Statistics for each input file.
-  static std::map<std::string, Statistics> stats;
-  // The Statistics objects for the currently-being-processed input file.
-  static Statistics* currentStatistics;
-  // Aggregate statistics over all entries in `stats` and return the resulting Statistics object.
+  // Write aggregated statistics for all registered counters as the final JSON Lines record.
+  static void printAggregateJSON(std::ostream *jsonl, bool bPerf = false);
+  // Print aggregated hot path counters.
+  static void printAggregatePerfCounters(std::ostream *csv, llvm::raw_ostream* printOut);
+  /**
+    * Write a snapshot of the aggregated statistics in OpenMetrics text format, suitable for
+    * the node-exporter textfile collector. The file is replaced atomically.
+    *
+    * @param fileName Path to the metrics file
+    * @return false if the file couldn't be written
+    */
+  static bool writeMetrics(const std::string &fileName);
+  // The Statistics object for the currently-being-processed input file; per thread, for libhipify.
+  static thread_local std::unique_ptr<Statistics> currentStatistics;
+  // The running aggregate of the Statistics of all the completed input files.
+  static std::unique_ptr<Statistics> aggregateStatistics;
+  // The number of files, which were successfully hipified with at least one change.
+  static unsigned convertedFiles;
+  // The number of processed files.
+  static unsigned processedFiles;
+  // The number of files, which failed to be hipified.
+  static unsigned failedFiles;
+  // The number of files, which hipification timed out on (-per-file-timeout); they are also counted as failed ones.
+  static unsigned timedOutFiles;
+  /**
+    * Fold the currently active Statistics into the running aggregate and release it, so that only the
+    * aggregate is kept in memory regardless of the number of processed files.
+    */
+  static void foldCurrent();
+  // Aggregate statistics over all the processed files and return the resulting Statistics object.
   static Statistics getAggregate();
   /**
-    * Convenient global entry point for updating the "active" Statistics. Since we operate single-threadedly
-    * processing one file at a time, this allows us to simply expose the stats for the current file globally,
+    * Convenient global entry point for updating the "active" Statistics. Since each thread processes
+    * one file at a time, this allows us to simply expose the stats for the current file globally,
     * simplifying things.
     */
   static Statistics &current();
   /**
-    * Set the active Statistics object to the named one, creating it if necessary, and write the completion
-    * timestamp into the currently active one.
+    * Set the active Statistics object to a newly created one for the named file. The previously active
+    * Statistics, which should already be printed, is folded into the running aggregate.
     */
   static void setActive(const std::string &name);
   // Check the counter and option TranslateToRoc whether it should be translated to Roc or not.
@@ -463,10 +618,18 @@ public:
   static bool isHipSupportedV2Only(const hipCounter& counter);
   // Check whether the counter is ROC_MIOPEN_ONLY or not.
   static bool isRocMiopenOnly(const hipCounter& counter);
+  // Check whether the counter is REMOVED_IN_TARGET or not.
+  static bool isRemovedInTarget(const hipCounter& counter);
   // Get string CUDA version.
   static std::string getCudaVersion(const cudaVersions &ver);
   // Get string HIP version.
   static std::string getHipVersion(const hipVersions &ver);
+  // Parse CUDA version "X.Y"; CUDA_0 if malformed.
+  static cudaVersions parseCudaVersion(llvm::StringRef ver);
+  // Parse HIP version "X.Y" or "X.Y.Z"; HIP_0 if malformed.
+  static hipVersions parseHipVersion(llvm::StringRef ver);
   // Set this flag in case of hipification errors.
   bool hasErrors = false;
+  // Set this flag if hipification timed out; unless the file is then hipified lexically, hasErrors is set as well.
+  bool timedOut = false;
 };
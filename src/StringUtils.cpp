@@ -21,8 +21,10 @@ THE SOFTWARE.
 */
 
 #include "StringUtils.h"
-#include "LLVMCompat.h"
+#include "LLVMCompatSupport.h"
 #include "llvm/ADT/SmallString.h"
+#include <cctype>
+#include <map>
 
 using namespace llvm;
 
@@ -37,6 +39,80 @@ void removePrefixIfPresent(std::string &s, const std::string &prefix) {
   s.erase(0, prefix.size());
 }
 
+namespace {
+
+struct TrieNode {
+  std::map<char, TrieNode> children;
+  bool bEnd = false;
+};
+
+std::string escapeRegexChar(char c) {
+  if (isalnum(static_cast<unsigned char>(c)) || c == '_') return std::string(1, c);
+  return std::string("\\") + c;
+}
+
+std::string trieToRegex(const TrieNode &node) {
+  std::vector<std::string> alts;
+  bool bChars = true;
+  for (const auto &child : node.children) {
+    std::string alt = escapeRegexChar(child.first) + trieToRegex(child.second);
+    if (!child.second.children.empty()) bChars = false;
+    alts.push_back(alt);
+  }
+  if (alts.empty()) return "";
+  std::string res;
+  if (alts.size() == 1) {
+    res = alts.front();
+  } else if (bChars) {
+    // All the alternatives are single characters: [abc]
+    res = "[";
+    for (const auto &alt : alts) res += alt;
+    res += "]";
+  } else {
+    res = "(?:";
+    for (size_t i = 0; i < alts.size(); ++i) res += (i ? "|" : "") + alts[i];
+    res += ")";
+  }
+  if (!node.bEnd) return res;
+  // A word ends here, so the rest is optional.
+  bool bAtom = (alts.size() == 1 && alts.front().size() == escapeRegexChar(node.children.begin()->first).size()) || alts.size() > 1;
+  return (bAtom ? res : "(?:" + res + ")") + "?";
+}
+
+} // namespace
+
+std::string buildTrieRegex(const std::vector<std::string> &words) {
+  TrieNode root;
+  for (const auto &word : words) {
+    if (word.empty()) continue;
+    TrieNode *node = &root;
+    for (char c : word) node = &node->children[c];
+    node->bEnd = true;
+  }
+  return trieToRegex(root);
+}
+
+bool matchesWildcard(StringRef s, StringRef pattern) {
+  // Greedy matching with backtracking to the last '*' only, which is sufficient for wildcards
+  size_t i = 0, p = 0, star = StringRef::npos, starMatch = 0;
+  while (i < s.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == s[i])) {
+      ++i;
+      ++p;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      starMatch = i;
+    } else if (star != StringRef::npos) {
+      p = star + 1;
+      i = ++starMatch;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*') ++p;
+  return p == pattern.size();
+}
+
 std::string getAbsoluteFilePath(const std::string &sFile, std::error_code &EC) {
   if (sFile.empty())
     return sFile;
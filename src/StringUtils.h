@@ -23,6 +23,7 @@ THE SOFTWARE.
 #pragma once
 
 #include <string>
+#include <vector>
 #include <system_error>
 #include "llvm/ADT/StringRef.h"
 
@@ -36,6 +37,18 @@ llvm::StringRef unquoteStr(llvm::StringRef s);
   */
 void removePrefixIfPresent(std::string &s, const std::string &prefix);
 
+/**
+  * Build a regular expression (Perl and Python compatible), matching any of `words`, in the form
+  * of a prefix trie: {"abc", "abd", "b"} => "(?:ab[cd]|b)". Returns an empty string for no words.
+  */
+std::string buildTrieRegex(const std::vector<std::string> &words);
+
+/**
+  * Match `s` against a shell-like wildcard `pattern`, in which '*' matches any sequence of characters
+  * (including an empty one) and '?' matches any single character.
+  */
+bool matchesWildcard(llvm::StringRef s, llvm::StringRef pattern);
+
 /**
   * Returns Absolute File Path based on filename, otherwise - error.
   */
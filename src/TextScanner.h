@@ -0,0 +1,115 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Endian.h"
+
+/**
+  * Count '\n' characters in `s`, processing 8 bytes at a time.
+  */
+inline size_t countNewLines(llvm::StringRef s) {
+  const uint64_t ones = 0x0101010101010101ULL;
+  const uint64_t low7 = 0x7f7f7f7f7f7f7f7fULL;
+  const uint64_t newLines = ones * '\n';
+  const char *p = s.data();
+  size_t size = s.size();
+  size_t res = 0;
+  while (size >= 8) {
+    // Per-byte counters of the block can't overflow: at most 255 words are accumulated.
+    uint64_t acc = 0;
+    for (unsigned i = 0; i < 255 && size >= 8; ++i, p += 8, size -= 8) {
+      uint64_t word;
+      memcpy(&word, p, 8);
+      uint64_t x = word ^ newLines;
+      // The high bit of a byte is set iff the byte of x is zero, i.e. the byte of the word is '\n'.
+      uint64_t zeros = ~(((x & low7) + low7) | x | low7);
+      acc += zeros >> 7;
+    }
+    // Sum up the per-byte counters.
+    acc = (acc & 0x00ff00ff00ff00ffULL) + ((acc >> 8) & 0x00ff00ff00ff00ffULL);
+    res += (acc * 0x0001000100010001ULL) >> 48;
+  }
+  for (; size > 0; ++p, --size)
+    if (*p == '\n') ++res;
+  return res;
+}
+
+// Scanning of the words, aka the runs of [A-Za-z0-9_] characters (Perl's \w), 8 bytes at a time.
+namespace scanner {
+
+  const uint64_t ones = 0x0101010101010101ULL;
+  const uint64_t low7 = 0x7f7f7f7f7f7f7f7fULL;
+  const uint64_t high = 0x8080808080808080ULL;
+
+  inline bool isWordChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+  }
+
+  // The high bit of a byte is set iff the byte is in (m, n), where m < 128 and n <= 128.
+  inline uint64_t bytesBetween(uint64_t x, uint64_t m, uint64_t n) {
+    return (ones * (127 + n) - (x & low7)) & ~x & ((x & low7) + ones * (127 - m)) & high;
+  }
+
+  // The high bit of a byte is set iff the byte is c.
+  inline uint64_t bytesEqual(uint64_t x, char c) {
+    uint64_t y = x ^ (ones * static_cast<unsigned char>(c));
+    return ~(((y & low7) + low7) | y | low7);
+  }
+
+  // The high bit of a byte is set iff the byte is a word character; the uppercase letters are folded to the lowercase ones by | 0x20.
+  inline uint64_t wordChars(uint64_t x) {
+    return bytesBetween(x, '0' - 1, '9' + 1) | bytesBetween(x | (ones * 0x20), 'a' - 1, 'z' + 1) | bytesEqual(x, '_');
+  }
+
+  // The index of the first byte with the high bit set in a non-zero mask of a little-endian block.
+  inline size_t firstByte(uint64_t mask) {
+    size_t i = 0;
+    for (; !(mask & 0x80); mask >>= 8) ++i;
+    return i;
+  }
+
+  // The index of the first character at or after i, which is (bWord) or is not (!bWord) a word character, or s.size().
+  inline size_t find(llvm::StringRef s, size_t i, bool bWord) {
+    const char *p = s.data();
+    const size_t size = s.size();
+    for (; i + 8 <= size; i += 8) {
+      uint64_t mask = wordChars(llvm::support::endian::read64le(p + i));
+      if (!bWord) mask = ~mask & high;
+      if (mask) return i + firstByte(mask);
+    }
+    while (i < size && isWordChar(p[i]) != bWord) ++i;
+    return i;
+  }
+
+  // Calls f(begin, end) for each word of s.
+  template<typename F> void forEachWord(llvm::StringRef s, F f) {
+    for (size_t i = find(s, 0, true); i < s.size(); i = find(s, i, true)) {
+      size_t end = find(s, i + 1, false);
+      f(i, end);
+      i = end;
+    }
+  }
+}
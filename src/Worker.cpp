@@ -0,0 +1,107 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "Worker.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <sstream>
+#include "llvm/Support/raw_ostream.h"
+#ifndef _WIN32
+#include <cerrno>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace chr = std::chrono;
+
+WorkerStatus runInWorker(const std::function<bool(std::ostream &output)> &job, unsigned seconds, std::string &output) {
+  output.clear();
+#ifdef _WIN32
+  std::stringstream stream;
+  bool bSucceeded = job(stream);
+  output = stream.str();
+  return bSucceeded ? WORKER_SUCCEEDED : WORKER_FAILED;
+#else
+  int fds[2];
+  if (pipe(fds)) {
+    return WORKER_FAILED;
+  }
+  // Otherwise, the buffered output would be written by both processes.
+  llvm::outs().flush();
+  pid_t pid = fork();
+  if (pid < 0) {
+    close(fds[0]);
+    close(fds[1]);
+    return WORKER_FAILED;
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    std::stringstream stream;
+    bool bSucceeded = job(stream);
+    llvm::outs().flush();
+    std::string data = stream.str();
+    for (size_t written = 0; written < data.size();) {
+      ssize_t res = write(fds[1], data.data() + written, data.size() - written);
+      if (res < 0 && errno == EINTR) continue;
+      if (res <= 0) _exit(1);
+      written += size_t(res);
+    }
+    // Skip the destructors and atexit handlers of the parent's state, e.g., of its threads.
+    _exit(bSucceeded ? 0 : 1);
+  }
+  close(fds[1]);
+  chr::steady_clock::time_point deadline = chr::steady_clock::now() + chr::seconds(seconds);
+  bool bTimedOut = false, bFinished = false;
+  char buffer[4096];
+  while (true) {
+    long long left = chr::duration_cast<chr::milliseconds>(deadline - chr::steady_clock::now()).count();
+    if (left <= 0) {
+      bTimedOut = true;
+      break;
+    }
+    struct pollfd pfd = {fds[0], POLLIN, 0};
+    int res = poll(&pfd, 1, int(std::min<long long>(left, INT_MAX)));
+    if (res < 0 && errno != EINTR) break;
+    if (res <= 0) continue;
+    ssize_t count = read(fds[0], buffer, sizeof(buffer));
+    if (count < 0 && errno == EINTR) continue;
+    // The end of the output: the worker has exited
+    if (count == 0) bFinished = true;
+    if (count <= 0) break;
+    output.append(buffer, size_t(count));
+  }
+  close(fds[0]);
+  if (!bFinished) {
+    kill(pid, SIGKILL);
+  }
+  int status = 0;
+  while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+  if (bTimedOut) {
+    return WORKER_TIMED_OUT;
+  }
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? WORKER_SUCCEEDED : WORKER_FAILED;
+#endif
+}
@@ -0,0 +1,43 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <string>
+
+enum WorkerStatus {
+  WORKER_SUCCEEDED = 0,
+  // The job returned false or the worker crashed
+  WORKER_FAILED,
+  WORKER_TIMED_OUT,
+};
+
+/**
+  * Run the job in a forked worker process, which is killed if it doesn't finish in `seconds`; what the job
+  * writes to its stream is passed back into `output`. A crash of the worker doesn't affect the caller.
+  * Where fork is unavailable (Windows), the job is run in the calling process without a time limit.
+  * The worker is forked, so the calling process shouldn't have other threads, which might hold locks.
+  */
+WorkerStatus runInWorker(const std::function<bool(std::ostream &output)> &job, unsigned seconds, std::string &output);
@@ -0,0 +1,601 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include "HipifyFast.h"
+#include "TextScanner.h"
+
+namespace fast {
+
+  using namespace hipify;
+  using llvm::StringRef;
+  using scanner::isWordChar;
+
+  const size_t npos = std::string::npos;
+
+  // Perl's \s
+  bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+  }
+
+  size_t skipSpaces(StringRef s, size_t i) {
+    while (i < s.size() && isSpace(s[i])) ++i;
+    return i;
+  }
+
+  // Perl's \b
+  bool isWordBoundary(StringRef s, size_t i) {
+    bool bBefore = i > 0 && isWordChar(s[i - 1]);
+    bool bAfter = i < s.size() && isWordChar(s[i]);
+    return bBefore != bAfter;
+  }
+
+  // The end of a device function's call \s*\(\s*.*\s*\), which starts at i, or npos.
+  size_t getCallEnd(StringRef s, size_t i) {
+    i = skipSpaces(s, i);
+    if (i >= s.size() || s[i] != '(') return npos;
+    size_t b = skipSpaces(s, i + 1);
+    size_t e = s.find('\n', b);
+    if (e == StringRef::npos) e = s.size();
+    size_t w = skipSpaces(s, e);
+    if (w < s.size() && s[w] == ')') return w + 1;
+    size_t r = s.substr(b, e - b).rfind(')');
+    return r == StringRef::npos ? npos : b + r + 1;
+  }
+
+  unsigned Stats::total() const {
+    unsigned total = 0;
+    for (unsigned c : counters) total += c;
+    return total;
+  }
+
+  void Stats::add(const Stats &stats) {
+    for (int i = 0; i < NUM_CONV_TYPES; ++i) counters[i] += stats.counters[i];
+    warnings += stats.warnings;
+    lines += stats.lines;
+    for (auto &t : stats.tagsToConvertedTags) tagsToConvertedTags[t.first] = t.second;
+    for (auto &c : stats.convertedTags) convertedTags[c.first] += c.second;
+    for (auto &c : stats.convertedCudaTags) convertedCudaTags[c.first] += c.second;
+  }
+
+  void Stats::convert(const std::string &cudaName, const std::string &hipName, ConvTypes type, unsigned count) {
+    counters[type] += count;
+    convertedTags[hipName] += count;
+    convertedCudaTags[cudaName] += count;
+    tagsToConvertedTags[cudaName] = hipName;
+  }
+
+  void Stats::print(llvm::raw_ostream &OS, const std::string &fileName) const {
+    OS << "\n[HIPIFY] info: file '" << fileName << "' statistics:\n";
+    OS << "  CONVERTED refs count: " << total() << "\n";
+    OS << "  TOTAL lines of code: " << lines << "\n";
+    OS << "  WARNINGS: " << warnings << "\n";
+    OS << "[HIPIFY] info: CONVERTED refs by names:\n";
+    for (auto &t : tagsToConvertedTags) {
+      auto found = convertedTags.find(t.second);
+      OS << "  " << t.first << " => " << t.second << ": " << (found != convertedTags.end() ? found->second : 0) << "\n";
+    }
+  }
+
+  Hipifier::Hipifier(const Options &options): options(options) {
+    if (options.bRoc)
+      for (auto &r : getIncludeRenames(rs_Roc)) includes.push_back({r.cudaName, r.hipName, r.type});
+    if (options.bExperimental)
+      for (auto &r : getIncludeRenames(rs_Experimental)) includes.push_back({r.cudaName, r.hipName, r.type});
+    for (auto &r : getIncludeRenames(rs_Simple)) includes.push_back({r.cudaName, r.hipName, r.type});
+    // The later sets override the earlier ones
+    std::vector<RenameSet> sets{rs_Simple};
+    if (options.bExperimental) sets.push_back(rs_Experimental);
+    if (options.bRoc) sets.push_back(rs_Roc);
+    if (!options.findRename)
+      for (auto set : sets)
+        for (auto &r : getNameRenames(set)) names[r.cudaName] = r;
+    trie.emplace_back();
+    VersionedNames deprecated, removed, experimental;
+    getVersionedNames(deprecated, removed, experimental);
+    std::vector<std::string> unsupported, hipUnsupported, rocUnsupported;
+    getUnsupportedNames(unsupported, hipUnsupported, rocUnsupported);
+    auto addVersioned = [this](const std::string &message, Category::Kind kind, const VersionedNames &versioned) {
+      std::vector<std::string> names, versions;
+      for (auto &v : versioned) {
+        names.push_back(v.first);
+        versions.push_back(v.second);
+      }
+      addCategory(message, kind, names, versions);
+    };
+    if (!options.bExperimental) addVersioned("experimental identifier", Category::k_InHip, experimental);
+    addVersioned("removed identifier", Category::k_SinceCuda, removed);
+    addVersioned("deprecated identifier", Category::k_SinceCuda, deprecated);
+    addCategory("unsupported identifier", Category::k_Plain, unsupported);
+    if (options.bRoc) addCategory("unsupported by ROC identifier", Category::k_Plain, rocUnsupported);
+    else addCategory("unsupported identifier", Category::k_Plain, hipUnsupported);
+    std::vector<std::string> supportedFuncs;
+    getDeviceFunctionNames(supportedFuncs, unsupportedDeviceFunctionNames);
+    for (unsigned i = 0; i < supportedFuncs.size(); ++i) supportedDeviceFunctions[supportedFuncs[i]] = i;
+    for (unsigned i = 0; i < unsupportedDeviceFunctionNames.size(); ++i) unsupportedDeviceFunctions[unsupportedDeviceFunctionNames[i]] = i;
+    whitelist.assign(Whitelist.begin(), Whitelist.end());
+    whitelist.insert(whitelist.end(), options.whitelist.begin(), options.whitelist.end());
+    argRewrites = getArgRewrites();
+  }
+
+  void Hipifier::addCategory(const std::string &message, Category::Kind kind, const std::vector<std::string> &names, const std::vector<std::string> &versions) {
+    unsigned category = categories.size();
+    categories.push_back({message, kind, names, versions});
+    for (unsigned i = 0; i < names.size(); ++i) {
+      unsigned node = 0;
+      for (char c : names[i]) {
+        auto &children = trie[node].children;
+        auto found = std::find_if(children.begin(), children.end(), [c](const std::pair<char, unsigned> &p) { return p.first == c; });
+        if (found != children.end()) {
+          node = found->second;
+          continue;
+        }
+        children.push_back({c, static_cast<unsigned>(trie.size())});
+        node = trie.size();
+        trie.emplace_back();
+      }
+      if (trie[node].name < 0) {
+        trie[node].name = warnNames.size();
+        warnNames.push_back({names[i], {}});
+      }
+      warnNames[trie[node].name].entries.push_back({category, i});
+    }
+  }
+
+  // hipify-perl: s/$i\b$a\b/$b/g, where '.' in $a is any character except '\n', and $i is a lookbehind for the includes only.
+  void Hipifier::substituteIncludes(std::string &text, Stats &stats) const {
+    static const char *excluded = "!~`@#^&*-+=[](){}.,?'>";
+    for (auto &inc : includes) {
+      const std::string &a = inc.cudaName;
+      size_t dot = a.find('.');
+      std::string prefix = a.substr(0, dot);
+      bool bLookbehind = inc.type == CONV_INCLUDE || inc.type == CONV_INCLUDE_CUDA_MAIN_H;
+      unsigned count = 0;
+      std::string res;
+      size_t done = 0;
+      for (size_t p = text.find(prefix); p != npos; p = text.find(prefix, p + 1)) {
+        if (p + a.size() > text.size()) break;
+        if (bLookbehind && p > 0 && (text[p - 1] == '\0' || strchr(excluded, text[p - 1]))) continue;
+        if (!isWordBoundary(text, p) || !isWordBoundary(text, p + a.size())) continue;
+        bool bMatch = true;
+        for (size_t i = dot; i < a.size() && bMatch; ++i)
+          bMatch = a[i] == '.' ? text[p + i] != '\n' : a[i] == text[p + i];
+        if (!bMatch) continue;
+        res.append(text, done, p - done);
+        res += inc.hipName;
+        done = p + a.size();
+        p = done - 1;
+        ++count;
+      }
+      if (!count) continue;
+      res.append(text, done, npos);
+      text.swap(res);
+      stats.convert(a, inc.hipName, inc.type, count);
+    }
+  }
+
+  void Hipifier::substituteNames(std::string &text, Stats &stats) const {
+    std::string res;
+    size_t done = 0;
+    Rename rename;
+    scanner::forEachWord(text, [&](size_t b, size_t e) {
+      StringRef word = StringRef(text).slice(b, e);
+      const Rename *found = nullptr;
+      if (options.findRename) {
+        if (options.findRename(word, rename)) found = &rename;
+      } else {
+        auto name = names.find(word);
+        if (name != names.end()) found = &name->second;
+      }
+      if (!found) return;
+      const Rename &r = *found;
+      res.append(text, done, b - done);
+      res += r.hipName;
+      done = e;
+      stats.convert(r.cudaName, r.hipName, r.type);
+    });
+    if (!done) return;
+    res.append(text, done, npos);
+    text.swap(res);
+  }
+
+  // A kernel launch's configuration argument as hipify-perl accepts it: a call or a constructor like dim3(x, y) is matched against
+  // ^([\w\s:]*\([\w|\s,:+*\-\/(?R)]+\))\s*\z, which trailing spaces are dropped by.
+  bool normalizeLaunchArg(std::string &arg) {
+    size_t b = skipSpaces(arg, 0);
+    if (b == arg.size() && b) arg = arg.substr(b - 1);
+    else arg.erase(0, b);
+    if (arg.find_first_of("()") != npos) {
+      size_t open = 0;
+      while (open < arg.size() && (isWordChar(arg[open]) || isSpace(arg[open]) || arg[open] == ':')) ++open;
+      if (open >= arg.size() || arg[open] != '(') return false;
+      size_t close = arg.size();
+      while (close > open && isSpace(arg[close - 1])) --close;
+      if (close < open + 3 || arg[--close] != ')') return false;
+      for (size_t i = open + 1; i < close; ++i)
+        if (!isWordChar(arg[i]) && !isSpace(arg[i]) && !strchr("|,:+*-/(?R)", arg[i])) return false;
+      arg.erase(close + 1);
+    }
+    return !arg.empty();
+  }
+
+  bool isKernelNameChar(char c) {
+    return isWordChar(c) || c == ':' || c == '|';
+  }
+
+  // The kernel name before the launch: /([:|\w]+)\s*\z/ or /^.*?([:|\w]+)\s*<([^\n]+)>\s*\z/s for a template.
+  bool getKernelName(StringRef before, std::string &name, size_t &nameStart) {
+    size_t last = before.size();
+    while (last > 0 && isSpace(before[last - 1])) --last;
+    if (last > 0 && isKernelNameChar(before[last - 1])) {
+      nameStart = last - 1;
+      while (nameStart > 0 && isKernelNameChar(before[nameStart - 1])) --nameStart;
+      name = before.slice(nameStart, last).str();
+      return true;
+    }
+    if (last == 0 || before[last - 1] != '>') return false;
+    size_t gt = last - 1;
+    for (size_t i = 0; i < gt; ++i) {
+      if (!isKernelNameChar(before[i])) continue;
+      size_t r = i;
+      while (r < gt && isKernelNameChar(before[r])) ++r;
+      size_t lt = skipSpaces(before, r);
+      if (lt + 2 <= gt && before[lt] == '<' && before.slice(lt + 1, gt).find('\n') == StringRef::npos) {
+        nameStart = i;
+        name = "HIP_KERNEL_NAME(" + before.slice(i, r).str() + "<" + before.slice(lt + 1, gt).str() + ">)";
+        return true;
+      }
+      i = r;
+    }
+    return false;
+  }
+
+  // A port of hipify-perl's single pass kernel launch rewriting.
+  unsigned Hipifier::transformKernelLaunch(std::string &text) const {
+    unsigned k = 0;
+    std::string res;
+    size_t done = 0;
+    for (size_t launch = text.find("<<<"); launch != npos; launch = text.find("<<<", launch + 3)) {
+      std::vector<std::string> args;
+      int depth = 0;
+      size_t argStart = launch + 3, configEnd = npos;
+      for (size_t i = launch + 3; i < text.size(); ++i) {
+        char c = text[i];
+        if (c == '(') {
+          depth++;
+        } else if (c == ')') {
+          if (!depth) break;
+          depth--;
+        } else if (depth) {
+          continue;
+        } else if (c == ',') {
+          args.push_back(text.substr(argStart, i - argStart));
+          argStart = i + 1;
+        } else if (c == '>' && text.compare(i, 3, ">>>") == 0) {
+          args.push_back(text.substr(argStart, i - argStart));
+          configEnd = i + 3;
+          break;
+        } else if (c == ';' || c == '{' || c == '}' || (c == '<' && text.compare(i, 3, "<<<") == 0)) {
+          break;
+        }
+      }
+      if (configEnd == npos || args.size() < 2 || args.size() > 4) continue;
+      bool bValid = true;
+      for (auto &arg : args) bValid = normalizeLaunchArg(arg) && bValid;
+      if (!bValid) continue;
+      size_t callEnd = skipSpaces(text, configEnd);
+      if (callEnd >= text.size() || text[callEnd] != '(') continue;
+      size_t close = skipSpaces(text, ++callEnd);
+      bool bNoArgs = close < text.size() && text[close] == ')';
+      if (bNoArgs) callEnd = close + 1;
+      size_t from = launch ? StringRef(text).rfind('\n', launch) : npos;
+      if (from != npos && from > 0) from = StringRef(text).rfind('\n', from);
+      if (from == npos || from < done) from = done;
+      std::string name;
+      size_t nameStart;
+      if (!getKernelName(StringRef(text).slice(from, launch), name, nameStart)) continue;
+      nameStart += from;
+      k++;
+      res.append(text, done, nameStart - done);
+      res += "hipLaunchKernelGGL(" + name + ", ";
+      for (unsigned i = 0; i < 4; ++i) res += (i ? ", " : "") + (i < args.size() ? args[i] : "0");
+      res += bNoArgs ? ")" : ", ";
+      done = callEnd;
+      launch = done - 3;
+    }
+    if (k) {
+      res.append(text, done, npos);
+      text.swap(res);
+    }
+    return k;
+  }
+
+  // s/using\s*namespace\s*cub/using namespace hipcub/g and s/\bcub::\b/hipcub::/g
+  unsigned Hipifier::transformCubNamespace(std::string &text) const {
+    unsigned k = 0;
+    std::string res;
+    size_t done = 0;
+    for (size_t p = text.find("using"); p != npos; p = text.find("using", p + 1)) {
+      size_t i = skipSpaces(text, p + 5);
+      if (text.compare(i, 9, "namespace")) continue;
+      i = skipSpaces(text, i + 9);
+      if (text.compare(i, 3, "cub")) continue;
+      res.append(text, done, p - done);
+      res += "using namespace hipcub";
+      done = i + 3;
+      p = done - 1;
+      ++k;
+    }
+    if (done) {
+      res.append(text, done, npos);
+      text.swap(res);
+      res.clear();
+      done = 0;
+    }
+    for (size_t p = text.find("cub::"); p != npos; p = text.find("cub::", p + 1)) {
+      if (!isWordBoundary(text, p) || !isWordBoundary(text, p + 5)) continue;
+      res.append(text, done, p - done);
+      res += "hipcub::";
+      done = p + 5;
+      ++k;
+    }
+    if (done) {
+      res.append(text, done, npos);
+      text.swap(res);
+    }
+    return k;
+  }
+
+  // hipify-perl's rewrites of the HIP functions' arguments by the regexes like
+  // s/(?<!\/\/ CHECK: )($func)\s*\(([^,\)]+),([\s]*)([^,\)]+)(,\s*|\))/$func\($2,$3HIP_SYMBOL\($4\)$5/g
+  unsigned Hipifier::transformHostFunctions(std::string &text) const {
+    unsigned k = 0;
+    const std::string sCheck = "// CHECK: ";
+    auto isArgChar = [](char c) { return c != ',' && c != ')'; };
+    for (auto &r : argRewrites) {
+      for (auto &func : r.funcs) {
+        std::string res;
+        size_t done = 0;
+        for (size_t p = text.find(func); p != npos; p = text.find(func, p + 1)) {
+          if (p >= sCheck.size() && text.compare(p - sCheck.size(), sCheck.size(), sCheck) == 0) continue;
+          size_t i = skipSpaces(text, p + func.size());
+          if (i >= text.size() || text[i] != '(') continue;
+          ++i;
+          // The preceding arguments, each is followed by a comma
+          std::vector<StringRef> args;
+          bool bMatch = true;
+          for (unsigned a = 0; a < std::max(r.argNum, 1u) && bMatch; ++a) {
+            size_t e = i;
+            while (e < text.size() && isArgChar(text[e])) ++e;
+            bMatch = e > i && e < text.size() && text[e] == ',';
+            if (bMatch) args.push_back(StringRef(text).slice(i, e));
+            i = e + 1;
+          }
+          if (!bMatch) continue;
+          std::string replacement = func + "(";
+          if (!r.argNum) {
+            replacement += getCastType(r.castType) + "(" + args[0].str() + "),";
+          } else {
+            // ([\s]*)([^,\)]+)(,\s*|\))
+            size_t w = skipSpaces(text, i);
+            if (w >= text.size() || !isArgChar(text[w])) {
+              if (w == i) continue;
+              --w;
+            }
+            size_t e = w;
+            while (e < text.size() && isArgChar(text[e])) ++e;
+            if (e >= text.size()) continue;
+            size_t end = text[e] == ',' ? skipSpaces(text, e + 1) : e + 1;
+            for (unsigned a = 0; a < args.size(); ++a) replacement += (a ? "," : "") + args[a].str();
+            if (r.castType != e_remove_argument)
+              replacement += "," + text.substr(i, w - i) + getCastType(r.castType) + "(" + text.substr(w, e - w) + ")";
+            replacement += text.substr(e, end - e);
+            i = end;
+          }
+          res.append(text, done, p - done);
+          res += replacement;
+          done = i;
+          p = done - 1;
+          ++k;
+        }
+        if (!done) continue;
+        res.append(text, done, npos);
+        text.swap(res);
+      }
+    }
+    return k;
+  }
+
+  // An occurrence of an identifier in a line: the index of the identifier in its category or list, the position and the length
+  struct Occurrence {
+    unsigned index;
+    size_t pos;
+    size_t len;
+  };
+
+  // Emulates hipify-perl's loop over the identifiers in their order, matching each of them by m/.../g, so that the matches share pos():
+  // an identifier without an occurrence fails and resets pos() to 0. match(occurrences of an identifier, pos) returns the end of its match or npos.
+  template<typename F> void matchInOrder(std::vector<Occurrence> &occurrences, size_t count, size_t &pos, F match, bool bUnordered = false) {
+    std::stable_sort(occurrences.begin(), occurrences.end(), [](const Occurrence &a, const Occurrence &b) { return a.index < b.index; });
+    size_t next = 0;
+    for (size_t o = 0; o < occurrences.size();) {
+      size_t last = o;
+      while (last < occurrences.size() && occurrences[last].index == occurrences[o].index) ++last;
+      if (occurrences[o].index != next || bUnordered) pos = 0;
+      next = occurrences[o].index + 1;
+      size_t end = match(llvm::makeArrayRef(occurrences).slice(o, last - o), pos);
+      pos = end == npos ? 0 : end;
+      o = last;
+    }
+    if (next != count || bUnordered) pos = 0;
+  }
+
+  // The device functions' calls without a namespace prefix: hipify-perl checks each function by m/(\w+)::($func)\s*\(\s*.*\s*\)/g
+  // and m/\b($func)\b\s*\(\s*.*\s*\)/g, but only if any of the functions is called, so that pos() is kept otherwise.
+  template<typename F> void matchDeviceFunctions(StringRef text, const llvm::StringMap<unsigned> &funcs, size_t &pos, F onCall) {
+    std::vector<Occurrence> occurrences;
+    bool bCalled = false;
+    scanner::forEachWord(text, [&](size_t b, size_t e) {
+      auto found = funcs.find(text.slice(b, e));
+      if (found == funcs.end()) return;
+      occurrences.push_back({found->second, b, e - b});
+      if (bCalled) return;
+      size_t i = skipSpaces(text, e);
+      bCalled = i < text.size() && text[i] == '(';
+    });
+    if (!bCalled) return;
+    matchInOrder(occurrences, funcs.size(), pos, [&](llvm::ArrayRef<Occurrence> occs, size_t &pos) {
+      size_t nsEnd = npos;
+      for (auto &o : occs) {
+        size_t q = o.pos;
+        if (q < 3 || text[q - 1] != ':' || text[q - 2] != ':' || !isWordChar(text[q - 3]) || q - 2 <= pos) continue;
+        if ((nsEnd = getCallEnd(text, q + o.len)) != npos) break;
+      }
+      pos = nsEnd == npos ? 0 : nsEnd;
+      size_t end = npos;
+      for (auto &o : occs) {
+        if (o.pos < pos) continue;
+        if ((end = getCallEnd(text, o.pos + o.len)) != npos) break;
+      }
+      if (end != npos && nsEnd == npos) onCall(occs.front().index);
+      return end;
+    });
+  }
+
+  unsigned Hipifier::warnUnsupported(StringRef line, const std::string &location, std::string &messages) const {
+    // The occurrences of the identifiers to warn about by the categories
+    std::vector<std::vector<Occurrence>> occurrences(categories.size());
+    bool bFound = false;
+    scanner::forEachWord(line, [&](size_t b, size_t e) {
+      for (size_t i = b; i < e; ++i) {
+        unsigned node = 0;
+        for (size_t j = i; j < e; ++j) {
+          auto &children = trie[node].children;
+          auto found = std::find_if(children.begin(), children.end(), [&](const std::pair<char, unsigned> &p) { return p.first == line[j]; });
+          if (found == children.end()) break;
+          node = found->second;
+          if (trie[node].name < 0) continue;
+          for (auto &entry : warnNames[trie[node].name].entries) occurrences[entry.first].push_back({entry.second, i, j + 1 - i});
+          bFound = true;
+        }
+      }
+    });
+    unsigned k = 0;
+    size_t pos = 0;
+    if (bFound) {
+      for (unsigned c = 0; c < categories.size(); ++c) {
+        if (occurrences[c].empty()) continue;
+        const Category &category = categories[c];
+        matchInOrder(occurrences[c], category.names.size(), pos, [&](llvm::ArrayRef<Occurrence> occs, size_t pos) {
+          for (auto &o : occs) {
+            if (o.pos < pos) continue;
+            const std::string &name = category.names[o.index];
+            messages += "  warning: " + location + ": " + category.message + " \"" + name + "\"";
+            if (category.kind == Category::k_InHip) {
+              messages += " in HIP " + category.versions[o.index];
+            } else if (category.kind == Category::k_SinceCuda) {
+              messages += StringRef(name).lower().find("cudnn") == 0 ? " since CUDNN " : " since CUDA ";
+              messages += category.versions[o.index];
+            }
+            messages += "\n";
+            ++k;
+            return o.pos + o.len;
+          }
+          return npos;
+        }, category.kind != Category::k_Plain);
+      }
+    }
+    matchDeviceFunctions(line, unsupportedDeviceFunctions, pos, [&](unsigned func) {
+      messages += "  warning: " + location + ": unsupported device function \"" + unsupportedDeviceFunctionNames[func] + "\": " + line.str() + "\n";
+      ++k;
+    });
+    return k;
+  }
+
+  // Any remaining identifier, which looks like a CUDA API one, and any remaining kernel launch in the hipified line are warned about.
+  unsigned Hipifier::warnUnconverted(StringRef line, const std::string &location, std::string &messages) const {
+    size_t lt = line.find("<<<");
+    bool bLaunch = options.bHipKernelExecutionSyntax && lt != StringRef::npos && line.find(">>>", lt + 3) != StringRef::npos;
+    if (!bLaunch && line.find("cuda") == StringRef::npos) return 0;
+    std::string zapped;
+    size_t done = 0;
+    bool bTag = false;
+    scanner::forEachWord(line, [&](size_t b, size_t e) {
+      StringRef word = line.slice(b, e);
+      if (std::find(whitelist.begin(), whitelist.end(), word) != whitelist.end()) {
+        zapped += line.slice(done, b);
+        zapped += "ZAP";
+        done = e;
+        return;
+      }
+      bTag = bTag || (word.size() > 5 && word.startswith("cuda") && word[4] >= 'A' && word[4] <= 'Z');
+    });
+    if (!bTag && !bLaunch) return 0;
+    zapped += line.substr(done);
+    messages += "  warning: " + location.substr(0, location.rfind(':') + 1) + "#" + location.substr(location.rfind(':') + 1) + " : " + zapped + "\n";
+    return 1;
+  }
+
+  void Hipifier::hipify(StringRef fileName, StringRef text, std::string &out, std::string &messages, Stats &stats) const {
+    if (text.empty()) return;
+    unsigned countKeywords = (text.find("__global__") != StringRef::npos) + (text.find("__shared__") != StringRef::npos);
+    auto forEachLine = [&fileName](StringRef text, const std::function<unsigned(StringRef, const std::string &)> &warn) {
+      unsigned k = 0, lineNum = 0;
+      for (size_t b = 0; b < text.size();) {
+        size_t e = text.find('\n', b);
+        if (e == StringRef::npos) e = text.size();
+        k += warn(text.slice(b, e), fileName.str() + ":" + std::to_string(++lineNum));
+        b = e + 1;
+      }
+      return k;
+    };
+    if (!options.bQuietWarnings)
+      stats.warnings += forEachLine(text, [&](StringRef line, const std::string &location) { return warnUnsupported(line, location, messages); });
+    std::string res = text.str();
+    substituteIncludes(res, stats);
+    substituteNames(res, stats);
+    if (options.bHipKernelExecutionSyntax) stats.counters[CONV_KERNEL_LAUNCH] += transformKernelLaunch(res);
+    transformCubNamespace(res);
+    unsigned hasDeviceCode = countKeywords + stats.counters[CONV_DEVICE_FUNC];
+    if (!options.bQuietWarnings)
+      stats.warnings += forEachLine(res, [&](StringRef line, const std::string &location) { return warnUnconverted(line, location, messages); });
+    if (hasDeviceCode > 0) {
+      size_t pos = 0;
+      matchDeviceFunctions(res, supportedDeviceFunctions, pos, [&](unsigned) { stats.counters[CONV_DEVICE_FUNC]++; });
+    }
+    transformHostFunctions(res);
+    if (!options.bNoOutput) {
+      unsigned apiCalls = stats.total() - stats.counters[CONV_DEVICE_FUNC] - stats.counters[CONV_EXTERN_SHARED] - stats.counters[CONV_KERNEL_LAUNCH];
+      unsigned kernStuff = hasDeviceCode + stats.counters[CONV_KERNEL_LAUNCH] + stats.counters[CONV_DEVICE_FUNC];
+      if (apiCalls + kernStuff && kernStuff) {
+        StringRef sRes = res;
+        bool bDos = sRes.endswith("\r\n") || sRes.endswith("\r\n\n");
+        out += "#include \"hip/hip_runtime.h\"";
+        out += bDos ? "\r\n" : "\n";
+      }
+      out += res;
+    }
+    stats.lines = std::count(res.begin(), res.end(), '\n');
+  }
+}
@@ -0,0 +1,129 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+#include "CUDA2HIP_Scripting.h"
+
+// hipify-fast: the lexical hipification of hipify-perl, performed natively on the same tables as hipify-clang uses.
+namespace fast {
+
+  struct Options {
+    bool bRoc = false;
+    bool bExperimental = false;
+    bool bHipKernelExecutionSyntax = false;
+    bool bQuietWarnings = false;
+    bool bNoOutput = false;
+    // Identifiers, which are not warned about in addition to the built-in hipify::Whitelist
+    std::vector<std::string> whitelist;
+    // The lookup of the identifiers' renames instead of the built-in tables, e.g., the one of hipify-clang pruned to the
+    // target versions or reading the mapping database; called for every word, so it should be a hashed lookup
+    std::function<bool(llvm::StringRef, hipify::Rename &)> findRename;
+  };
+
+  // Statistics in hipify-perl's format: of a single file or of all the files.
+  struct Stats {
+    unsigned counters[NUM_CONV_TYPES] = {};
+    unsigned warnings = 0;
+    unsigned lines = 0;
+    std::map<std::string, std::string> tagsToConvertedTags;
+    std::map<std::string, unsigned> convertedTags;
+    // The counts of the converted CUDA tags
+    std::map<std::string, unsigned> convertedCudaTags;
+
+    unsigned total() const;
+    void add(const Stats &stats);
+    void convert(const std::string &cudaName, const std::string &hipName, ConvTypes type, unsigned count = 1);
+    void print(llvm::raw_ostream &OS, const std::string &fileName) const;
+  };
+
+  class Hipifier {
+  public:
+    explicit Hipifier(const Options &options);
+    // Hipifies the text of a file: the hipified text goes to out, the warnings - to messages.
+    void hipify(llvm::StringRef fileName, llvm::StringRef text, std::string &out, std::string &messages, Stats &stats) const;
+
+  private:
+    struct Include {
+      // The CUDA include with '.' matching any character but '\n', as in hipify-perl's regex
+      std::string cudaName;
+      std::string hipName;
+      ConvTypes type;
+    };
+
+    // A node of the trie of the identifiers to warn about, which are matched anywhere in a word, as in hipify-perl
+    struct TrieNode {
+      std::vector<std::pair<char, unsigned>> children;
+      int name = -1;
+    };
+
+    // A category of the identifiers to warn about, each is checked by a separate function of hipify-perl
+    struct Category {
+      enum Kind {
+        k_Plain,
+        k_InHip,
+        k_SinceCuda,
+      };
+      std::string message;
+      // hipify-perl checks the versioned identifiers in the random order of a hash, so they are matched independently of each other
+      Kind kind;
+      // The identifiers, and the versions for the versioned ones
+      std::vector<std::string> names;
+      std::vector<std::string> versions;
+    };
+
+    // An identifier to warn about with its categories and indices in them
+    struct WarnName {
+      std::string name;
+      std::vector<std::pair<unsigned, unsigned>> entries;
+    };
+
+    Options options;
+    std::vector<Include> includes;
+    llvm::StringMap<hipify::Rename> names;
+    std::vector<TrieNode> trie;
+    std::vector<WarnName> warnNames;
+    // In the order of hipify-perl's checks
+    std::vector<Category> categories;
+    std::vector<std::string> unsupportedDeviceFunctionNames;
+    llvm::StringMap<unsigned> supportedDeviceFunctions;
+    llvm::StringMap<unsigned> unsupportedDeviceFunctions;
+    std::vector<std::string> whitelist;
+    std::vector<hipify::ArgRewrite> argRewrites;
+
+    void addCategory(const std::string &message, Category::Kind kind, const std::vector<std::string> &names, const std::vector<std::string> &versions = {});
+    void substituteIncludes(std::string &text, Stats &stats) const;
+    void substituteNames(std::string &text, Stats &stats) const;
+    unsigned transformKernelLaunch(std::string &text) const;
+    unsigned transformCubNamespace(std::string &text) const;
+    unsigned transformHostFunctions(std::string &text) const;
+    unsigned warnUnsupported(llvm::StringRef line, const std::string &location, std::string &messages) const;
+    unsigned warnUnconverted(llvm::StringRef line, const std::string &location, std::string &messages) const;
+  };
+}
@@ -0,0 +1,289 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "CUDA2HIP.h"
+#include "Options.h"
+#include "HipifyFast.h"
+#include "MappingOverlay.h"
+
+using namespace llvm;
+
+// hipify-fast has the options of hipify-perl
+
+cl::OptionCategory FastCategory("hipify-fast options");
+
+cl::opt<bool> CudaKernelExecutionSyntax("cuda-kernel-execution-syntax",
+  cl::desc("Keep CUDA kernel launch syntax (default)"),
+  cl::cat(FastCategory));
+
+cl::opt<bool> Examine("examine",
+  cl::desc("Combines -no-output and -print-stats options"),
+  cl::cat(FastCategory));
+
+cl::opt<std::string> ExcludeDirs("exclude-dirs",
+  cl::desc("Exclude directories"),
+  cl::value_desc("directories"),
+  cl::cat(FastCategory));
+
+cl::opt<std::string> ExcludeFiles("exclude-files",
+  cl::desc("Exclude files"),
+  cl::value_desc("files"),
+  cl::cat(FastCategory));
+
+cl::opt<bool> Experimental("experimental",
+  cl::desc("HIPIFY experimentally supported APIs"),
+  cl::cat(FastCategory));
+
+cl::opt<bool> HipKernelExecutionSyntax("hip-kernel-execution-syntax",
+  cl::desc("Transform CUDA kernel launch syntax to a regular HIP function call (overrides \"--cuda-kernel-execution-syntax\")"),
+  cl::cat(FastCategory));
+
+cl::opt<bool> Inplace("inplace",
+  cl::desc("Backup the input file in .prehip file, modify the input file inplace"),
+  cl::cat(FastCategory));
+
+cl::opt<unsigned> Jobs("j",
+  cl::desc("Number of parallel jobs (only with -inplace or -no-output)"),
+  cl::value_desc("jobs"),
+  cl::init(1),
+  cl::cat(FastCategory));
+
+cl::opt<std::string> MappingOverlay("mapping-overlay",
+  cl::desc("Load the additional CUDA to HIP mappings from the tab-separated file"),
+  cl::value_desc("file"),
+  cl::cat(FastCategory));
+
+cl::opt<bool> NoOutput("no-output",
+  cl::desc("Don't write any translated output to stdout"),
+  cl::cat(FastCategory));
+
+cl::opt<std::string> OutputFilename("o",
+  cl::desc("Output filename"),
+  cl::value_desc("filename"),
+  cl::cat(FastCategory));
+
+cl::opt<bool> PrintStats("print-stats",
+  cl::desc("Print translation statistics"),
+  cl::cat(FastCategory));
+
+cl::opt<bool> QuietWarnings("quiet-warnings",
+  cl::desc("Don't print warnings on unknown CUDA identifiers"),
+  cl::cat(FastCategory));
+
+cl::opt<bool, true> TranslateToRocOption("roc",
+  cl::location(TranslateToRoc),
+  cl::desc("Translate to roc instead of hip where it is possible"),
+  cl::cat(FastCategory));
+
+// Not an option of hipify-fast: the shared tables' checks depend on it
+cl::opt<bool, true> TranslateToMIOpenOption("miopen",
+  cl::location(TranslateToMIOpen),
+  cl::ReallyHidden);
+
+cl::opt<std::string> IdentifierWhitelist("whitelist",
+  cl::desc("Whitelist of identifiers"),
+  cl::value_desc("identifiers"),
+  cl::cat(FastCategory));
+
+cl::list<std::string> SourceFiles(cl::Positional,
+  cl::desc("<source files>"),
+  cl::ZeroOrMore,
+  cl::cat(FastCategory));
+
+namespace {
+
+// Perl's split(',', $s)
+std::vector<std::string> split(const std::string &s) {
+  SmallVector<StringRef, 8> parts;
+  StringRef(s).split(parts, ',');
+  while (!parts.empty() && parts.back().empty()) parts.pop_back();
+  std::vector<std::string> res;
+  for (auto &p : parts) res.push_back(p.str());
+  return res;
+}
+
+std::error_code realPath(const std::string &path, SmallVectorImpl<char> &output) {
+#if LLVM_VERSION_MAJOR < 5
+  output.clear();
+  output.append(path.begin(), path.end());
+  return sys::fs::make_absolute(output);
+#else
+  return sys::fs::real_path(path, output);
+#endif
+}
+
+struct FileResult {
+  std::string messages;
+  std::string output;
+  fast::Stats stats;
+  bool bFailed = false;
+};
+
+// Hipifies a file the way hipify-perl does: the hipified text goes to the output file, if any, otherwise to result.output.
+void hipifyFile(const fast::Hipifier &hipifier, const std::string &fileName, const std::set<std::string> &excludeDirs,
+                const std::set<std::string> &excludeFiles, FileResult &result) {
+  SmallString<256> path;
+  std::string fileDir = realPath(fileName, path) ? "." : sys::path::parent_path(path).str();
+  bool bExcludedDir = excludeDirs.count(fileDir) > 0, bExcludedFile = excludeFiles.count(fileName) > 0;
+  if (bExcludedDir) result.messages += "Skipping the file: " + fileName + " in the excluded directory: " + fileDir + " \n";
+  if (bExcludedFile) result.messages += "Skipping the excluded file: " + fileName + " \n";
+  if (bExcludedDir || bExcludedFile) return;
+  std::string inFile = fileName, outFile = OutputFilename;
+  if (Inplace) {
+    inFile = fileName + ".prehip";
+    outFile = fileName;
+    if (!sys::fs::exists(inFile) && sys::fs::copy_file(fileName, inFile)) {
+      result.messages += "error: could not copy " + fileName + " to " + inFile + "\n";
+      result.bFailed = true;
+      return;
+    }
+  }
+  auto buffer = MemoryBuffer::getFile(inFile);
+  if (!buffer) {
+    result.messages += "error: could not open " + inFile + "\n";
+    result.bFailed = true;
+    return;
+  }
+  std::ofstream out;
+  if (!outFile.empty()) {
+    out.open(outFile, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      result.messages += "error: could not open " + outFile + "\n";
+      result.bFailed = true;
+      return;
+    }
+  }
+  hipifier.hipify(fileName, buffer.get()->getBuffer(), result.output, result.messages, result.stats);
+  if (out.is_open()) {
+    out << result.output;
+    result.output.clear();
+  }
+  if ((result.stats.total() + result.stats.warnings) && PrintStats) {
+    raw_string_ostream OS(result.messages);
+    result.stats.print(OS, fileName);
+  }
+}
+
+} // namespace
+
+int main(int argc, const char **argv) {
+  cl::HideUnrelatedOptions(FastCategory);
+#if LLVM_VERSION_MAJOR > 5
+  cl::SetVersionPrinter([](raw_ostream &) { errs() << "HIP version " << sHIP_version << "\n"; });
+#else
+  cl::SetVersionPrinter([]() { errs() << "HIP version " << sHIP_version << "\n"; });
+#endif
+  cl::ParseCommandLineOptions(argc, argv, "hipify-fast is a tool to translate CUDA source code into portable HIP C++\n");
+  if (Examine) {
+    PrintStats = true;
+    NoOutput = true;
+  }
+  if (!MappingOverlay.empty()) {
+    std::string sErrorMessage;
+    if (!loadMappingOverlay(MappingOverlay, sErrorMessage)) {
+      errs() << "error: " << sErrorMessage << "\n";
+      return 1;
+    }
+  }
+  fast::Options options;
+  options.bRoc = TranslateToRoc;
+  options.bExperimental = Experimental;
+  options.bHipKernelExecutionSyntax = HipKernelExecutionSyntax;
+  options.bQuietWarnings = QuietWarnings;
+  options.bNoOutput = NoOutput;
+  options.whitelist = split(IdentifierWhitelist);
+  const fast::Hipifier hipifier(options);
+  std::vector<std::string> dirs = split(ExcludeDirs), files = split(ExcludeFiles);
+  const std::set<std::string> excludeDirs(dirs.begin(), dirs.end()), excludeFiles(files.begin(), files.end());
+  fast::Stats totalStats;
+  size_t fileCount = SourceFiles.size();
+  std::vector<FileResult> results(fileCount);
+  bool bFailed = false;
+  // Flushes the results in order of the files, as soon as they are ready
+  auto flush = [&](FileResult &result) {
+    errs() << result.messages;
+    if (!result.output.empty()) outs() << result.output;
+    outs().flush();
+    totalStats.add(result.stats);
+    bFailed = bFailed || result.bFailed;
+    result = FileResult();
+  };
+  unsigned jobs = std::min<size_t>(Jobs, fileCount);
+  if (jobs > 1 && (Inplace || NoOutput)) {
+    // The next file to claim, the stop on a failure, and the readiness of the files are guarded by the mutex,
+    // so that every claimed file is either flushed or waited for, once the workers are stopped.
+    size_t next = 0;
+    bool bStop = false;
+    std::vector<char> ready(fileCount, 0);
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::thread> workers;
+    for (unsigned j = 0; j < jobs; ++j) {
+      workers.emplace_back([&]() {
+        for (;;) {
+          size_t i;
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (bStop || next >= fileCount) return;
+            i = next++;
+          }
+          hipifyFile(hipifier, SourceFiles[i], excludeDirs, excludeFiles, results[i]);
+          std::lock_guard<std::mutex> lock(mutex);
+          if (results[i].bFailed) bStop = true;
+          ready[i] = 1;
+          cv.notify_one();
+        }
+      });
+    }
+    for (size_t i = 0; i < fileCount; ++i) {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&]() { return ready[i] || (bStop && i >= next); });
+      if (!ready[i]) break;
+      lock.unlock();
+      flush(results[i]);
+    }
+    for (auto &w : workers) w.join();
+    if (bFailed) return 1;
+  } else {
+    for (size_t i = 0; i < fileCount; ++i) {
+      hipifyFile(hipifier, SourceFiles[i], excludeDirs, excludeFiles, results[i]);
+      flush(results[i]);
+      if (bFailed) return 1;
+    }
+  }
+  if (PrintStats && fileCount > 1) {
+    totalStats.print(errs(), "GLOBAL");
+    errs() << "\n";
+  }
+  return 0;
+}
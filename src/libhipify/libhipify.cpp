@@ -0,0 +1,169 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include <atomic>
+#include "libhipify.h"
+#include "CUDA2HIP.h"
+#include "HipifyAction.h"
+#include "LLVMCompat.h"
+#include "MappingDB.h"
+#include "MappingOverlay.h"
+#include "Options.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+
+namespace libhipify {
+
+std::vector<std::string> getClangArgs(const Options &options, const std::string &sSourceAbsPath) {
+  std::vector<std::string> args{"-x", "cuda"};
+  llcompat::addTargetIfNeeded(args);
+  if (!options.sCudaPath.empty()) {
+    args.push_back("--cuda-path=" + options.sCudaPath);
+  }
+  if (!options.sCudaGpuArch.empty()) {
+    args.push_back("--cuda-gpu-arch=" + options.sCudaGpuArch);
+  }
+  args.push_back("--cuda-host-only");
+  if (llcompat::pragma_once_outside_header()) {
+    args.push_back("-Wno-pragma-once-outside-header");
+  }
+  args.push_back("-fno-delayed-template-parsing");
+  args.push_back("-I" + llvm::sys::path::parent_path(sSourceAbsPath).str());
+#if defined(HIPIFY_CLANG_RES)
+  args.push_back("-resource-dir=" HIPIFY_CLANG_RES);
+#endif
+  // Standard c++14 by default
+  args.push_back("-std=c++14");
+  std::string hipify_parent_path = std::string(llvm::sys::path::parent_path(options.sHipifyPath));
+  // Includes for clang's CUDA wrappers for using by new and old packaged hipify-clang
+  std::string clang_inc_path_new = hipify_parent_path + "/../include/hipify";
+  std::string clang_inc_path_old = hipify_parent_path + "/include";
+  for (const std::string &path : {clang_inc_path_new + "/cuda_wrappers", clang_inc_path_new, clang_inc_path_old + "/cuda_wrappers", clang_inc_path_old}) {
+    args.insert(args.end(), {"-Xclang", "-internal-isystem", "-Xclang", path});
+  }
+  // The last specified macros and include directories go first, as hipify-clang has always passed them
+  for (size_t i = options.macroNames.size(); i > 0; --i) {
+    args.insert(args.end(), {"-D", options.macroNames[i - 1]});
+  }
+  for (size_t i = options.includeDirs.size(); i > 0; --i) {
+    args.insert(args.end(), {"-I", options.includeDirs[i - 1]});
+  }
+  return args;
+}
+
+namespace {
+  // Whether a Hipifier has been created in the process: the state of the tables, which it sets up (the -roc and -miopen
+  // translation, the overlay, the mapping database, and the target versions), is process-wide and can't be undone.
+  std::atomic<bool> bHipifierCreated(false);
+}
+
+std::unique_ptr<Hipifier> Hipifier::create(const Options &options, std::string &sErrorMessage) {
+  if (bHipifierCreated.exchange(true)) {
+    sErrorMessage = "only one Hipifier might be created in the process";
+    return nullptr;
+  }
+  std::unique_ptr<Hipifier> hipifier(new Hipifier(options));
+  if (!hipifier->init(sErrorMessage)) {
+    return nullptr;
+  }
+  return hipifier;
+}
+
+bool Hipifier::init(std::string &sErrorMessage) {
+  TranslateToRoc = options.bRoc;
+  TranslateToMIOpen = options.bMIOpen;
+  if (!llcompat::CheckCompatibility(options.bSkipExcludedPPConditionalBlocks)) {
+    sErrorMessage = "incompatible options";
+    return false;
+  }
+  if (!options.sMappingOverlay.empty() && !loadMappingOverlay(options.sMappingOverlay, sErrorMessage)) {
+    return false;
+  }
+  if (!options.sMappingDatabase.empty() && !openMappingDB(options.sMappingDatabase, sErrorMessage)) {
+    return false;
+  }
+  if (!options.sCudaVersion.empty() || !options.sHipVersion.empty()) {
+    cudaVersions cudaVersion = CUDA_0;
+    hipVersions hipVersion = HIP_0;
+    if (!options.sCudaVersion.empty() && CUDA_0 == (cudaVersion = Statistics::parseCudaVersion(options.sCudaVersion))) {
+      sErrorMessage = "Wrong CUDA version: \"" + options.sCudaVersion + "\"; must be X.Y";
+      return false;
+    }
+    if (!options.sHipVersion.empty() && HIP_0 == (hipVersion = Statistics::parseHipVersion(options.sHipVersion))) {
+      sErrorMessage = "Wrong HIP version: \"" + options.sHipVersion + "\"; must be X.Y or X.Y.Z";
+      return false;
+    }
+    setTargetVersions(cudaVersion, hipVersion);
+  }
+  // The tables are built lazily at the first use; build them now, so that the concurrent calls only read them.
+  CUDA_RENAMES_MAP();
+  CUDA_RECORDS();
+  if (options.bIncludeDrivenRenames) {
+    for (int api = 0; api < NUM_API_TYPES; ++api) CUDA_API_RENAMES_MAP(ApiTypes(api));
+  }
+  if (options.sHipifyPath.empty()) {
+    static int Dummy;
+    options.sHipifyPath = llvm::sys::fs::getMainExecutable("", (void *)&Dummy);
+  }
+  return true;
+}
+
+Result Hipifier::hipify(llvm::StringRef source, const std::string &filePath, const std::vector<std::string> &compileFlags) const {
+  Result result;
+  llvm::SmallString<256> sourceAbsPath(filePath);
+  llvm::sys::fs::make_absolute(sourceAbsPath);
+  std::string sSourceAbsPath = sourceAbsPath.str().str();
+  // The Statistics of this thread are of the file until they are moved into the result.
+  Statistics::currentStatistics.reset(new Statistics(filePath));
+  Statistics &currentStat = Statistics::current();
+  currentStat.setSource(source);
+  chr::steady_clock::time_point phaseStart = chr::steady_clock::now();
+  std::vector<std::string> args = getClangArgs(options, sSourceAbsPath);
+  args.insert(args.end(), compileFlags.begin(), compileFlags.end());
+  ct::Replacements replacements;
+  HipifyAction::Options actionOptions;
+  actionOptions.bExperimental = options.bExperimental;
+  actionOptions.bCudaKernelExecutionSyntax = options.bCudaKernelExecutionSyntax;
+  actionOptions.bHipKernelExecutionSyntax = options.bHipKernelExecutionSyntax;
+  actionOptions.bSkipExcludedPPConditionalBlocks = options.bSkipExcludedPPConditionalBlocks;
+  actionOptions.bIncludeDrivenRenames = options.bIncludeDrivenRenames;
+  // The touched lines and bytes are always counted in the statistics of the results.
+  actionOptions.bCountTouched = true;
+  std::unique_ptr<clang::FrontendAction> action(new HipifyAction(&replacements, actionOptions));
+  currentStat.addPhaseDuration(PHASE_PREPARE, chr::steady_clock::now() - phaseStart);
+  phaseStart = chr::steady_clock::now();
+  // The source is parsed from memory; the files it includes are read from disk.
+  result.bSucceeded = llcompat::runToolOnCodeWithArgs(std::move(action), source, args, sSourceAbsPath) &&
+                      llcompat::applyAllReplacements(source, replacements, result.hipified);
+  currentStat.addPhaseDuration(PHASE_HIPIFY, chr::steady_clock::now() - phaseStart);
+  for (const auto &r : replacements) {
+    result.replacements.push_back({r.getOffset(), r.getLength(), r.getReplacementText().str()});
+  }
+  currentStat.hasErrors = !result.bSucceeded;
+  currentStat.markCompletion();
+  result.statistics = std::move(Statistics::currentStatistics);
+  return result;
+}
+
+} // namespace libhipify
@@ -0,0 +1,103 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "llvm/ADT/StringRef.h"
+#include "Statistics.h"
+
+// libhipify: hipify-clang embedded in-process, a source buffer in and the hipified buffer out.
+namespace libhipify {
+
+  // The counterparts of hipify-clang's options; see hipify-clang --help.
+  struct Options {
+    bool bRoc = false;
+    bool bMIOpen = false;
+    bool bExperimental = false;
+    bool bCudaKernelExecutionSyntax = false;
+    bool bHipKernelExecutionSyntax = false;
+    bool bSkipExcludedPPConditionalBlocks = false;
+    bool bIncludeDrivenRenames = false;
+    std::string sCudaPath;
+    std::string sCudaGpuArch;
+    std::string sMappingOverlay;
+    std::string sMappingDatabase;
+    std::string sCudaVersion;
+    std::string sHipVersion;
+    // The path to hipify-clang, next to which clang's CUDA wrappers are packaged; the running executable by default
+    std::string sHipifyPath;
+    std::vector<std::string> includeDirs;
+    std::vector<std::string> macroNames;
+  };
+
+  struct Replacement {
+    unsigned offset = 0;
+    unsigned length = 0;
+    std::string text;
+  };
+
+  struct Result {
+    // false if the source failed to be parsed or the replacements failed to be applied
+    bool bSucceeded = false;
+    std::string hipified;
+    // Sorted by offset in the source
+    std::vector<Replacement> replacements;
+    std::unique_ptr<Statistics> statistics;
+  };
+
+  class Hipifier {
+  public:
+    /**
+      * Create the hipifier: the options are applied and the tables are built once, to be reused by all the calls.
+      * The options of the clang invocations and of the hipification are kept by the hipifier, while bRoc, bMIOpen,
+      * sMappingOverlay, sMappingDatabase, sCudaVersion, and sHipVersion set up the process-wide state of the tables,
+      * which can't be undone. So only one Hipifier might be created in the process; the next calls fail.
+      * The library doesn't register any command line options in the process.
+      *
+      * @return nullptr on wrong options or if a Hipifier has already been created, with the reason in sErrorMessage
+      */
+    static std::unique_ptr<Hipifier> create(const Options &options, std::string &sErrorMessage);
+    /**
+      * Hipify the source of the file, which doesn't need to exist on disk; the includes are resolved relative
+      * to the file's directory. Might be called concurrently from several threads.
+      *
+      * @param compileFlags Additional clang flags for the file, e.g. the ones of its compilation database entry
+      */
+    Result hipify(llvm::StringRef source, const std::string &filePath, const std::vector<std::string> &compileFlags = {}) const;
+
+  private:
+    explicit Hipifier(const Options &options): options(options) {}
+    // Apply the options, which set up the state of the tables
+    bool init(std::string &sErrorMessage);
+    Options options;
+  };
+
+  /**
+    * The clang arguments, which hipify-clang inserts before the ones of the file: the CUDA language and paths,
+    * clang's CUDA wrappers (next to options.sHipifyPath), the file's directory, and the -I and -D options.
+    */
+  std::vector<std::string> getClangArgs(const Options &options, const std::string &sSourceAbsPath);
+}
@@ -27,13 +27,24 @@ THE SOFTWARE.
 #include <chrono>
 #include <iomanip>
 #include <sstream>
+#include <tuple>
 #include "CUDA2HIP.h"
 #include "CUDA2HIP_Scripting.h"
 #include "LLVMCompat.h"
 #include "HipifyAction.h"
 #include "ArgParse.h"
 #include "StringUtils.h"
+#include "TextScanner.h"
+#include "SourceQueue.h"
+#include "Worker.h"
+#include "MappingOverlay.h"
+#include "MappingDB.h"
+#include "fast/HipifyFast.h"
+#include "libhipify/libhipify.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Regex.h"
 #include "clang/Basic/Diagnostic.h"
 #include "clang/Basic/DiagnosticIDs.h"
 #include "clang/Basic/DiagnosticOptions.h"
@@ -41,6 +52,7 @@ THE SOFTWARE.
 #include "clang/Driver/Compilation.h"
 #include "clang/Driver/Tool.h"
 #include "clang/Frontend/TextDiagnosticPrinter.h"
+#include "clang/Tooling/CommonOptionsParser.h"
 
 #if LLVM_VERSION_MAJOR < 8
 #include "llvm/Support/Path.h"
@@ -103,72 +115,95 @@ void sortInputFiles(int argc, const char **argv, std::vector<std::string> &files
 }
 
 void appendArgumentsAdjusters(ct::RefactoringTool &Tool, const std::string &sSourceAbsPath, const char *hipify_exe) {
-  if (!IncludeDirs.empty()) {
-    for (std::string s : IncludeDirs) {
-      Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster(s.c_str(), ct::ArgumentInsertPosition::BEGIN));
-      Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-I", ct::ArgumentInsertPosition::BEGIN));
-    }
-  }
-  if (!MacroNames.empty()) {
-    for (std::string s : MacroNames) {
-      Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster(s.c_str(), ct::ArgumentInsertPosition::BEGIN));
-      Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-D", ct::ArgumentInsertPosition::BEGIN));
-    }
-  }
   static int Dummy;
-  std::string hipify = llvm::sys::fs::getMainExecutable(hipify_exe, (void *)&Dummy);
-  std::string hipify_parent_path = std::string(llvm::sys::path::parent_path(hipify));
-  // Includes for clang's CUDA wrappers for using by old packaged hipify-clang
-  std::string clang_inc_path_old = hipify_parent_path + "/include";
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster(clang_inc_path_old.c_str(), ct::ArgumentInsertPosition::BEGIN));
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-Xclang", ct::ArgumentInsertPosition::BEGIN));
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-internal-isystem", ct::ArgumentInsertPosition::BEGIN));
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-Xclang", ct::ArgumentInsertPosition::BEGIN));
-  clang_inc_path_old.append("/cuda_wrappers");
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster(clang_inc_path_old.c_str(), ct::ArgumentInsertPosition::BEGIN));
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-Xclang", ct::ArgumentInsertPosition::BEGIN));
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-internal-isystem", ct::ArgumentInsertPosition::BEGIN));
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-Xclang", ct::ArgumentInsertPosition::BEGIN));
-  // Includes for clang's CUDA wrappers for using by new packaged hipify-clang
-  std::string clang_inc_path_new = hipify_parent_path + "/../include/hipify";
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster(clang_inc_path_new.c_str(), ct::ArgumentInsertPosition::BEGIN));
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-Xclang", ct::ArgumentInsertPosition::BEGIN));
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-internal-isystem", ct::ArgumentInsertPosition::BEGIN));
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-Xclang", ct::ArgumentInsertPosition::BEGIN));
-  clang_inc_path_new.append("/cuda_wrappers");
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster(clang_inc_path_new.c_str(), ct::ArgumentInsertPosition::BEGIN));
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-Xclang", ct::ArgumentInsertPosition::BEGIN));
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-internal-isystem", ct::ArgumentInsertPosition::BEGIN));
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-Xclang", ct::ArgumentInsertPosition::BEGIN));
-  // Standard c++14 by default
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-std=c++14", ct::ArgumentInsertPosition::BEGIN));
-  std::string sInclude = "-I" + sys::path::parent_path(sSourceAbsPath).str();
-#if defined(HIPIFY_CLANG_RES)
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-resource-dir=" HIPIFY_CLANG_RES, ct::ArgumentInsertPosition::BEGIN));
-#endif
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster(sInclude.c_str(), ct::ArgumentInsertPosition::BEGIN));
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-fno-delayed-template-parsing", ct::ArgumentInsertPosition::BEGIN));
-  if (llcompat::pragma_once_outside_header()) {
-    Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-Wno-pragma-once-outside-header", ct::ArgumentInsertPosition::BEGIN));
-  }
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("--cuda-host-only", ct::ArgumentInsertPosition::BEGIN));
-  if (!CudaGpuArch.empty()) {
-    std::string sCudaGpuArch = "--cuda-gpu-arch=" + CudaGpuArch;
-    Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster(sCudaGpuArch.c_str(), ct::ArgumentInsertPosition::BEGIN));
-  }
-  if (!CudaPath.empty()) {
-    std::string sCudaPath = "--cuda-path=" + CudaPath;
-    Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster(sCudaPath.c_str(), ct::ArgumentInsertPosition::BEGIN));
-  }
-  llcompat::addTargetIfNeeded(Tool);
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("cuda", ct::ArgumentInsertPosition::BEGIN));
-  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-x", ct::ArgumentInsertPosition::BEGIN));
+  libhipify::Options options;
+  options.sCudaPath = CudaPath;
+  options.sCudaGpuArch = CudaGpuArch;
+  options.sHipifyPath = llvm::sys::fs::getMainExecutable(hipify_exe, (void *)&Dummy);
+  options.includeDirs.assign(IncludeDirs.begin(), IncludeDirs.end());
+  options.macroNames.assign(MacroNames.begin(), MacroNames.end());
+  Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster(libhipify::getClangArgs(options, sSourceAbsPath), ct::ArgumentInsertPosition::BEGIN));
   if (Verbose) {
     Tool.appendArgumentsAdjuster(ct::getInsertArgumentAdjuster("-v", ct::ArgumentInsertPosition::END));
   }
   Tool.appendArgumentsAdjuster(ct::getClangSyntaxOnlyAdjuster());
 }
 
+// Whether the source contains constructs, which need the AST to be hipified: kernel launches, calls of the functions
+// with argument casts, cub namespace uses, or identifiers, whose hipification depends on the included cuBLAS header.
+bool needsClang(StringRef source) {
+  if (source.find("<<<") != StringRef::npos) return true;
+  static const llvm::StringSet<> clangNames = [] {
+    llvm::StringSet<> names;
+    for (const auto &f : FuncArgCasts) names.insert(f.first);
+    for (const auto &ns : CUDA_CUB_NAMESPACE_MAP) names.insert(ns.first);
+    for (const auto &r : CUDA_RENAMES_MAP()) {
+      if (Statistics::isHipSupportedV2Only(r.second)) names.insert(r.first);
+    }
+    return names;
+  }();
+  bool bNeeds = false;
+  scanner::forEachWord(source, [&](size_t begin, size_t end) {
+    bNeeds = bNeeds || clangNames.count(source.slice(begin, end));
+  });
+  return bNeeds;
+}
+
+// Count the lines and bytes changed by the lexical engine; the lines inserted at the beginning are skipped.
+// The engine might also join lines, e.g. by removing an argument, so the hipified text might have fewer lines.
+void countChanges(StringRef source, StringRef hipified, Statistics &stat) {
+  for (long long inserted = (long long)countNewLines(hipified) - (long long)countNewLines(source); inserted > 0; --inserted) {
+    hipified = hipified.split('\n').second;
+  }
+  for (unsigned lineNumber = 1; !source.empty() || !hipified.empty(); ++lineNumber) {
+    StringRef before, after;
+    std::tie(before, source) = source.split('\n');
+    std::tie(after, hipified) = hipified.split('\n');
+    if (before == after) continue;
+    size_t prefix = 0, suffix = 0;
+    while (prefix < before.size() && prefix < after.size() && before[prefix] == after[prefix]) ++prefix;
+    while (suffix < before.size() - prefix && suffix < after.size() - prefix &&
+           before[before.size() - suffix - 1] == after[after.size() - suffix - 1]) ++suffix;
+    stat.lineTouched(lineNumber);
+    stat.bytesChanged(unsigned(before.size() - prefix - suffix));
+  }
+}
+
+// Hipify the source by the lexical engine into dst through the temporary file tmp, collecting the statistics as hipify-clang does.
+bool hipifyLexically(const fast::Hipifier &hipifier, const std::string &src, StringRef source, const std::string &dst, StringRef tmp) {
+  Statistics &currentStat = Statistics::current();
+  currentStat.setSource(source);
+  std::string hipified, messages;
+  fast::Stats stats;
+  hipifier.hipify(src, source, hipified, messages, stats);
+  llvm::errs() << messages;
+  for (const auto &tag : stats.convertedCudaTags) {
+    hipCounter counter;
+    const auto found = CUDA_INCLUDE_MAP.find(tag.first);
+    if (found != CUDA_INCLUDE_MAP.end()) counter = found->second;
+    else if (!findRename(tag.first, counter)) continue;
+    for (unsigned i = 0; i < tag.second; ++i) currentStat.incrementCounter(counter, tag.first);
+  }
+  countChanges(source, hipified, currentStat);
+  if (NoOutput) return true;
+  // The output might be the input (-inplace), so it is overwritten only once the temporary file is written completely.
+  std::ofstream out(tmp.str(), std::ios_base::binary | std::ios_base::trunc);
+  out << hipified;
+  out.close();
+  if (!out) {
+    llvm::errs() << "\n" << sHipify << sError << "while writing " << tmp << "\n";
+    currentStat.hasErrors = true;
+    return false;
+  }
+  std::error_code EC = sys::fs::copy_file(tmp, dst);
+  if (EC) {
+    llvm::errs() << "\n" << sHipify << sError << EC.message() << ": while copying " << tmp << " to " << dst << "\n";
+    currentStat.hasErrors = true;
+    return false;
+  }
+  return true;
+}
+
 bool generatePython() {
   bool bToRoc = TranslateToRoc;
   TranslateToRoc = true;
@@ -203,7 +238,8 @@ int main(int argc, const char **argv) {
     llvm::errs() << "\n" << sHipify << sError << "Must specify compilation database directory" << "\n";
     return 1;
   }
-  if (!bCompilationDatabase && std::find(new_argv.begin(), new_argv.end(), std::string("--")) == new_argv.end()) {
+  // The compilation database is streamed by hipify-clang itself, so it shouldn't be loaded by CommonOptionsParser.
+  if (std::find(new_argv.begin(), new_argv.end(), std::string("--")) == new_argv.end()) {
     new_argv.push_back("--");
     new_argv.push_back(nullptr);
     argv = new_argv.data();
@@ -220,23 +256,55 @@ int main(int argc, const char **argv) {
 #else
   ct::CommonOptionsParser OptionsParser(argc, argv, ToolTemplateCategory, llvm::cl::ZeroOrMore);
 #endif
-  if (!llcompat::CheckCompatibility()) {
+  if (!llcompat::CheckCompatibility(SkipExcludedPPConditionalBlocks)) {
     return 1;
   }
+  // compile_commands.json is streamed; any other compilation database (e.g., compile_flags.txt) is loaded as a whole.
+  // The positional sources, if any, select the files of the streamed database to hipify.
+  std::string sCompilationDatabase;
+  std::vector<std::string> databaseSources;
   std::unique_ptr<ct::CompilationDatabase> compilationDatabase;
   std::vector<std::string> fileSources;
   if (bCompilationDatabase) {
-    std::string serr;
-    compilationDatabase = ct::CompilationDatabase::loadFromDirectory(sCompilationDatabaseDir, serr);
-    if (nullptr == compilationDatabase.get()) {
-      llvm::errs() << "\n" << sHipify << sError << "loading Compilation Database from \"" << sCompilationDatabaseDir << "compile_commands.json\" failed\n";
-      return 1;
+    SmallString<256> compilationDatabasePath(sCompilationDatabaseDir);
+    sys::path::append(compilationDatabasePath, "compile_commands.json");
+    if (sys::fs::exists(compilationDatabasePath)) {
+      sCompilationDatabase = compilationDatabasePath.str().str();
+      databaseSources = OptionsParser.getSourcePathList();
+    } else {
+      std::string serr;
+      compilationDatabase = ct::CompilationDatabase::loadFromDirectory(sCompilationDatabaseDir, serr);
+      if (nullptr == compilationDatabase.get()) {
+        llvm::errs() << "\n" << sHipify << sError << "loading Compilation Database from \"" << sCompilationDatabaseDir << "\" failed: " << serr << "\n";
+        return 1;
+      }
+      fileSources = compilationDatabase->getAllFiles();
+      // compile_flags.txt lists no files, but applies to the positional ones.
+      if (fileSources.empty()) {
+        fileSources = OptionsParser.getSourcePathList();
+      }
     }
-    fileSources = compilationDatabase->getAllFiles();
   } else {
     fileSources = OptionsParser.getSourcePathList();
   }
-  if (fileSources.empty() && !GeneratePerl && !GeneratePython && !GenerateMarkdown && !GenerateCSV) {
+  if (!bCompilationDatabase && (!IncludePathRegex.empty() || !ExcludePathRegex.empty())) {
+    llvm::errs() << "\n" << sHipify << sError << "Path regular expressions are applied to a compilation database only; must specify -p" << "\n";
+    return 1;
+  }
+  for (const std::string &sRegex : {std::string(IncludePathRegex), std::string(ExcludePathRegex)}) {
+    std::string sRegexError;
+    if (!sRegex.empty() && !llvm::Regex(sRegex).isValid(sRegexError)) {
+      llvm::errs() << "\n" << sHipify << sError << "Wrong path regular expression: \"" << sRegex << "\": " << sRegexError << "\n";
+      return 1;
+    }
+  }
+  if (compilationDatabase) {
+    llvm::Regex includePathRegex(IncludePathRegex), excludePathRegex(ExcludePathRegex);
+    fileSources.erase(std::remove_if(fileSources.begin(), fileSources.end(), [&](const std::string &sFile) {
+      return (!IncludePathRegex.empty() && !includePathRegex.match(sFile)) || (!ExcludePathRegex.empty() && excludePathRegex.match(sFile));
+    }), fileSources.end());
+  }
+  if (fileSources.empty() && sCompilationDatabase.empty() && SourceDir.empty() && FilesFrom.empty() && !GeneratePerl && !GeneratePython && !GenerateMarkdown && !GenerateCSV) {
     llvm::errs() << "\n" << sHipify << sError << "Must specify at least 1 positional argument for source file" << "\n";
     return 1;
   }
@@ -244,6 +312,37 @@ int main(int argc, const char **argv) {
     llvm::errs() << "\n" << sHipify << sError << "Must specify a document type to generate: \"md\" and | or \"csv\"" << "\n";
     return 1;
   }
+  if (!StatsFormat.empty() && StatsFormat != "csv" && StatsFormat != "jsonl") {
+    llvm::errs() << "\n" << sHipify << sError << "Unsupported statistics format: \"" << StatsFormat << "\"; must be \"csv\" or \"jsonl\"" << "\n";
+    return 1;
+  }
+  if (!MappingOverlay.empty()) {
+    std::string sErrorMessage;
+    if (!loadMappingOverlay(MappingOverlay, sErrorMessage)) {
+      llvm::errs() << "\n" << sHipify << sError << sErrorMessage << "\n";
+      return 1;
+    }
+  }
+  if (!MappingDatabase.empty()) {
+    std::string sErrorMessage;
+    if (!openMappingDB(MappingDatabase, sErrorMessage)) {
+      llvm::errs() << "\n" << sHipify << sError << sErrorMessage << "\n";
+      return 1;
+    }
+  }
+  if (!TargetCudaVersion.empty() || !TargetHipVersion.empty()) {
+    cudaVersions cudaVersion = CUDA_0;
+    hipVersions hipVersion = HIP_0;
+    if (!TargetCudaVersion.empty() && CUDA_0 == (cudaVersion = Statistics::parseCudaVersion(TargetCudaVersion))) {
+      llvm::errs() << "\n" << sHipify << sError << "Wrong CUDA version: \"" << TargetCudaVersion << "\"; must be X.Y" << "\n";
+      return 1;
+    }
+    if (!TargetHipVersion.empty() && HIP_0 == (hipVersion = Statistics::parseHipVersion(TargetHipVersion))) {
+      llvm::errs() << "\n" << sHipify << sError << "Wrong HIP version: \"" << TargetHipVersion << "\"; must be X.Y or X.Y.Z" << "\n";
+      return 1;
+    }
+    setTargetVersions(cudaVersion, hipVersion);
+  }
   if (!perl::generate(GeneratePerl)) {
     llvm::errs() << "\n" << sHipify << sError << "hipify-perl generating failed" << "\n";
     return 1;
@@ -256,7 +355,7 @@ int main(int argc, const char **argv) {
     llvm::errs() << "\n" << sHipify << sError << "Documentation generating failed" << "\n";
     return 1;
   }
-  if (fileSources.empty()) {
+  if (fileSources.empty() && sCompilationDatabase.empty() && SourceDir.empty() && FilesFrom.empty()) {
     return 0;
   }
   std::string dst = OutputFilename, dstDir = OutputDir;
@@ -265,8 +364,14 @@ int main(int argc, const char **argv) {
   if (EC) {
     return 1;
   }
+  std::string sSourceDirAbsPath = getAbsoluteDirectoryPath(SourceDir, EC, "source", false);
+  if (EC) {
+    return 1;
+  }
+  // The number of the files found by walking the directory or read from the list is unknown until the end of hipification.
+  bool bMultipleSources = fileSources.size() > 1 || (!sCompilationDatabase.empty() && databaseSources.size() != 1) || !SourceDir.empty() || !FilesFrom.empty();
   if (!dst.empty()) {
-    if (fileSources.size() > 1) {
+    if (bMultipleSources) {
       llvm::errs() << sHipify << sConflict << "-o and multiple source files are specified\n";
       return 1;
     }
@@ -290,6 +395,11 @@ int main(int argc, const char **argv) {
     llvm::errs() << sHipify << sConflict << "both -o-dir and -inplace options are specified\n";
     return 1;
   }
+  // The lexical engine doesn't preprocess the files, so it doesn't know the included headers.
+  if (IncludeDrivenRenames && (Hybrid || TimeoutLexicalRetry)) {
+    llvm::errs() << sHipify << sConflict << "both -include-driven-renames and " << (Hybrid ? "-hybrid" : "-timeout-lexical-retry") << " options are specified\n";
+    return 1;
+  }
   if (Examine) {
     NoOutput = PrintStats = true;
   }
@@ -304,13 +414,20 @@ int main(int argc, const char **argv) {
   // Arguments for the Statistics print routines.
   std::unique_ptr<std::ostream> csv = nullptr;
   llvm::raw_ostream *statPrint = nullptr;
+  llvm::raw_ostream *perfPrint = nullptr;
   bool create_csv = false;
+  // In JSON Lines format, records are streamed into the statistics file instead of CSV.
+  bool bStatsJSONL = StatsFormat == "jsonl";
+  if (bStatsJSONL) {
+    PrintStatsCSV = true;
+    csv_ext = "jsonl";
+  }
   if (!OutputStatsFilename.empty()) {
     PrintStatsCSV = true;
     create_csv = true;
   } else {
-    if (PrintStatsCSV && fileSources.size() > 1) {
-      OutputStatsFilename = "sum_stat.csv";
+    if (PrintStatsCSV && bMultipleSources) {
+      OutputStatsFilename = "sum_stat." + csv_ext.str();
       create_csv = true;
     }
   }
@@ -323,8 +440,75 @@ int main(int argc, const char **argv) {
   if (PrintStats) {
     statPrint = &llvm::errs();
   }
+  // The perf counters go along with the statistics; they are printed to the terminal unless only the statistics file is requested.
+  if (PrintPerfCounters && (PrintStats || !PrintStatsCSV)) {
+    perfPrint = &llvm::errs();
+  }
+  HipifyAction::Options actionOptions;
+  actionOptions.bExperimental = Experimental;
+  actionOptions.bCudaKernelExecutionSyntax = CudaKernelExecutionSyntax;
+  actionOptions.bHipKernelExecutionSyntax = HipKernelExecutionSyntax;
+  actionOptions.bSkipExcludedPPConditionalBlocks = SkipExcludedPPConditionalBlocks;
+  actionOptions.bIncludeDrivenRenames = IncludeDrivenRenames;
+  // The touched lines and bytes are counted only if the statistics are printed.
+  actionOptions.bCountTouched = PrintStats || PrintStatsCSV;
   sortInputFiles(argc, argv, fileSources);
+  std::unique_ptr<fast::Hipifier> hipifier;
+  if (Hybrid || (PerFileTimeout && TimeoutLexicalRetry)) {
+    fast::Options options;
+    options.bRoc = TranslateToRoc;
+    options.bExperimental = Experimental;
+    // The renames pruned to the target versions and the ones of the mapping database are looked up as hipify-clang does,
+    // so that the files hipified by either engine, and their statistics, agree.
+    if (getMappingDB() || CUDA_TARGET_RENAMES_MAP()) {
+      options.findRename = [](StringRef name, hipify::Rename &rename) {
+        hipCounter counter;
+        return findRename(name, counter) && hipify::getNameRename(name, counter, TranslateToRoc, Experimental, rename);
+      };
+    }
+    hipifier = std::unique_ptr<fast::Hipifier>(new fast::Hipifier(options));
+  }
+  // The metrics file is refreshed not more often than once per the interval.
+  const chr::seconds metricsInterval(10);
+  chr::steady_clock::time_point metricsTime = chr::steady_clock::now();
+  // The positional sources go first, followed by the sources read from the compilation database, found by walking
+  // the directory, and read from the list, which are hipified while they are still being read or walked.
+  SourceQueue sources;
   for (const auto &src : fileSources) {
+    sources.push({src, "", ""});
+  }
+  if (!sCompilationDatabase.empty()) {
+    std::string sIncludePathRegex = IncludePathRegex, sExcludePathRegex = ExcludePathRegex;
+    sources.produce([sCompilationDatabase, sIncludePathRegex, sExcludePathRegex, databaseSources](SourceQueue &queue) {
+      readCompilationDatabase(sCompilationDatabase, sIncludePathRegex, sExcludePathRegex, databaseSources, queue);
+    });
+  }
+  if (!sSourceDirAbsPath.empty()) {
+    std::vector<std::string> extensions = SourceDirExtensions.empty() ? defaultSourceExtensions : std::vector<std::string>(SourceDirExtensions.begin(), SourceDirExtensions.end());
+    std::vector<std::string> ignorePatterns(SourceDirIgnore.begin(), SourceDirIgnore.end());
+    sources.produce([sSourceDirAbsPath, extensions, ignorePatterns](SourceQueue &queue) {
+      walkSourceDirectory(sSourceDirAbsPath, extensions, ignorePatterns, queue);
+    });
+  }
+  if (!FilesFrom.empty()) {
+    std::string sFilesFrom = FilesFrom;
+    sources.produce([sFilesFrom](SourceQueue &queue) {
+      readSourceList(sFilesFrom, queue);
+    });
+  }
+  // The workers of --per-file-timeout are forked, which is safe only if the process has no other threads,
+  // so all the sources are collected first.
+  if (PerFileTimeout) {
+    sources.join();
+  }
+  for (Source source; sources.pop(source);) {
+    if (!source.error.empty()) {
+      llvm::errs() << "\n" << sHipify << sError << source.error << "\n";
+      Result = 1;
+      continue;
+    }
+    const std::string &src = source.path;
+    chr::steady_clock::time_point phaseStart = chr::steady_clock::now();
     // Create a copy of the file to work on. When we're done, we'll move this onto the
     // output (which may mean overwriting the input, if we're in-place).
     // Should we fail for some reason, we'll just leak this file and not corrupt the input.
@@ -339,10 +523,36 @@ int main(int argc, const char **argv) {
       } else {
         dst = src + "." + ext.str();
         if (!dstDir.empty()) {
-          dst = sOutputDirAbsPath + "/" + sourceFileName.str() + "." + ext.str();
+          if (source.relativePath.empty()) {
+            dst = sOutputDirAbsPath + "/" + sourceFileName.str() + "." + ext.str();
+          } else {
+            // Mirror the walked directory structure, so that the files with the same names don't collide.
+            dst = sOutputDirAbsPath + "/" + source.relativePath + "." + ext.str();
+            StringRef dstParentDir = sys::path::parent_path(dst);
+            EC = NoOutput ? std::error_code() : sys::fs::create_directories(dstParentDir);
+            if (EC) {
+              llvm::errs() << "\n" << sHipify << sError << EC.message() << ": output directory: " << dstParentDir << "\n";
+              Result = 1;
+              dst.clear();
+              continue;
+            }
+          }
         }
       }
     }
+    // In the hybrid mode, the files, which don't need the AST, are hipified by the lexical engine.
+    std::unique_ptr<llvm::MemoryBuffer> lexicalSource;
+    if (Hybrid) {
+      auto buffer = llvm::MemoryBuffer::getFile(sSourceAbsPath);
+      if (!buffer) {
+        llvm::errs() << "\n" << sHipify << sError << buffer.getError().message() << ": while reading " << src << "\n";
+        Result = 1;
+        dst.clear();
+        continue;
+      }
+      if (!needsClang((*buffer)->getBuffer())) lexicalSource = std::move(*buffer);
+    }
+    bool bLexical = lexicalSource != nullptr;
     if (TemporaryDir.empty()) {
       EC = sys::fs::createTemporaryFile(sourceFileName, ext, tmpFile);
       if (EC) {
@@ -354,11 +564,14 @@ int main(int argc, const char **argv) {
       sTmpFileName = sTmpDirAbsParh + "/" + sourceFileName.str() + "." + ext.str();
       tmpFile = sTmpFileName;
     }
-    EC = sys::fs::copy_file(src, tmpFile);
-    if (EC) {
-      llvm::errs() << "\n" << sHipify << sError << EC.message() << ": while copying " << src << " to " << tmpFile << "\n";
-      Result = 1;
-      continue;
+    // The lexical engine writes its output into the temporary file itself.
+    if (!bLexical) {
+      EC = sys::fs::copy_file(src, tmpFile);
+      if (EC) {
+        llvm::errs() << "\n" << sHipify << sError << EC.message() << ": while copying " << src << " to " << tmpFile << "\n";
+        Result = 1;
+        continue;
+      }
     }
     if (PrintStatsCSV) {
       if (OutputStatsFilename.empty()) {
@@ -373,39 +586,111 @@ int main(int argc, const char **argv) {
     }
     // Initialise the statistics counters for this file.
     Statistics::setActive(src);
-    // RefactoringTool operates on the file in-place. Giving it the output path is no good,
-    // because that'll break relative includes, and we don't want to overwrite the input file.
-    // So what we do is operate on a copy, which we then move to the output.
-    ct::RefactoringTool Tool((bCompilationDatabase ? *compilationDatabase.get() : OptionsParser.getCompilations()), std::string(tmpFile.c_str()));
-    ct::Replacements &replacementsToUse = llcompat::getReplacements(Tool, tmpFile.c_str());
-    ReplacementsFrontendActionFactory<HipifyAction> actionFactory(&replacementsToUse);
-    appendArgumentsAdjusters(Tool, sSourceAbsPath, argv[0]);
     Statistics &currentStat = Statistics::current();
-    // Hipify _all_ the things!
-    if (Tool.runAndSave(&actionFactory)) {
-      currentStat.hasErrors = true;
-      Result = 1;
-      LLVM_DEBUG(llvm::dbgs() << "Skipped some replacements.\n");
-    }
-    // Copy the tmpfile to the output
-    if (!NoOutput && !currentStat.hasErrors) {
-      EC = sys::fs::copy_file(tmpFile, dst);
-      if (EC) {
-        llvm::errs() << "\n" << sHipify << sError << EC.message() << ": while copying " << tmpFile << " to " << dst << "\n";
+    if (bLexical) {
+      currentStat.addPhaseDuration(PHASE_PREPARE, chr::steady_clock::now() - phaseStart);
+      phaseStart = chr::steady_clock::now();
+      if (!hipifyLexically(*hipifier, src, lexicalSource->getBuffer(), dst, tmpFile)) {
         Result = 1;
-        continue;
+      }
+      currentStat.addPhaseDuration(PHASE_HIPIFY, chr::steady_clock::now() - phaseStart);
+      if (!SaveTemps) {
+        sys::fs::remove(tmpFile);
+      }
+    } else {
+      // RefactoringTool operates on the file in-place. Giving it the output path is no good,
+      // because that'll break relative includes, and we don't want to overwrite the input file.
+      // So what we do is operate on a copy, which we then move to the output.
+      // The compile command of a compilation database entry is applied to the copy as is, in the entry's directory.
+      std::unique_ptr<ct::CompilationDatabase> sourceCompilations;
+      if (!source.directory.empty()) {
+        sourceCompilations.reset(new ct::FixedCompilationDatabase(source.directory, source.arguments));
+      }
+      ct::CompilationDatabase &compilations = sourceCompilations ? *sourceCompilations : compilationDatabase ? *compilationDatabase : OptionsParser.getCompilations();
+      ct::RefactoringTool Tool(compilations, std::string(tmpFile.c_str()));
+      ct::Replacements &replacementsToUse = llcompat::getReplacements(Tool, tmpFile.c_str());
+      ReplacementsFrontendActionFactory<HipifyAction> actionFactory(&replacementsToUse, actionOptions);
+      appendArgumentsAdjusters(Tool, sSourceAbsPath, argv[0]);
+      currentStat.addPhaseDuration(PHASE_PREPARE, chr::steady_clock::now() - phaseStart);
+      phaseStart = chr::steady_clock::now();
+      // Hipify _all_ the things!
+      bool bHipified = true, bRetriedLexically = false;
+      if (PerFileTimeout) {
+        // The worker process is killed on timeout, as clang can't be interrupted; its statistics are passed back.
+        std::string workerOutput;
+        WorkerStatus status = runInWorker([&Tool, &actionFactory](std::ostream &out) {
+          bool bSucceeded = !Tool.runAndSave(&actionFactory);
+          Statistics::current().serialize(out);
+          return bSucceeded;
+        }, PerFileTimeout, workerOutput);
+        Statistics workerStat(src);
+        std::istringstream workerStream(workerOutput);
+        if (workerStat.deserialize(workerStream)) {
+          currentStat.add(workerStat);
+        }
+        bHipified = status == WORKER_SUCCEEDED;
+        if (status == WORKER_TIMED_OUT) {
+          currentStat.timedOut = true;
+          llvm::errs() << "\n" << sHipify << sError << "hipification of '" << src << "' timed out after " << PerFileTimeout << " s\n";
+          if (TimeoutLexicalRetry) {
+            llvm::errs() << sHipify << "info: file '" << src << "' is retried by the lexical engine\n";
+            auto buffer = llvm::MemoryBuffer::getFile(sSourceAbsPath);
+            if (!buffer) {
+              llvm::errs() << "\n" << sHipify << sError << buffer.getError().message() << ": while reading " << src << "\n";
+            }
+            bHipified = bRetriedLexically = buffer && hipifyLexically(*hipifier, src, (*buffer)->getBuffer(), dst, tmpFile);
+          }
+        }
+      } else {
+        bHipified = !Tool.runAndSave(&actionFactory);
+      }
+      if (!bHipified) {
+        currentStat.hasErrors = true;
+        Result = 1;
+        LLVM_DEBUG(llvm::dbgs() << "Skipped some replacements.\n");
+      }
+      currentStat.addPhaseDuration(PHASE_HIPIFY, chr::steady_clock::now() - phaseStart);
+      phaseStart = chr::steady_clock::now();
+      // Copy the tmpfile to the output, unless the output is already written by the lexical engine
+      if (!NoOutput && !currentStat.hasErrors && !bRetriedLexically) {
+        EC = sys::fs::copy_file(tmpFile, dst);
+        currentStat.addPhaseDuration(PHASE_OUTPUT, chr::steady_clock::now() - phaseStart);
+        if (EC) {
+          llvm::errs() << "\n" << sHipify << sError << EC.message() << ": while copying " << tmpFile << " to " << dst << "\n";
+          Result = 1;
+          continue;
+        }
+      }
+      // Remove the tmp file without error check
+      if (!SaveTemps) {
+        sys::fs::remove(tmpFile);
       }
     }
-    // Remove the tmp file without error check
-    if (!SaveTemps) {
-      sys::fs::remove(tmpFile);
+    if (Hybrid) {
+      llvm::errs() << sHipify << "info: file '" << src << "' hipified by " << (bLexical ? "the lexical engine" : "clang") << "\n";
     }
     Statistics::current().markCompletion();
-    Statistics::current().print(csv.get(), statPrint);
+    Statistics::current().print(bStatsJSONL ? nullptr : csv.get(), statPrint);
+    if (PrintPerfCounters) {
+      Statistics::current().printPerfCounters(bStatsJSONL ? nullptr : csv.get(), perfPrint);
+    }
+    Statistics::current().printJSON(bStatsJSONL ? csv.get() : nullptr, PrintPerfCounters);
     dst.clear();
+    if (!MetricsFilename.empty() && chr::steady_clock::now() - metricsTime >= metricsInterval) {
+      Statistics::writeMetrics(MetricsFilename);
+      metricsTime = chr::steady_clock::now();
+    }
+  }
+  if (bMultipleSources) {
+    Statistics::printAggregate(bStatsJSONL ? nullptr : csv.get(), statPrint);
+    if (PrintPerfCounters) {
+      Statistics::printAggregatePerfCounters(bStatsJSONL ? nullptr : csv.get(), perfPrint);
+    }
+    Statistics::printAggregateJSON(bStatsJSONL ? csv.get() : nullptr, PrintPerfCounters);
   }
-  if (fileSources.size() > 1) {
-    Statistics::printAggregate(csv.get(), statPrint);
+  if (!MetricsFilename.empty() && !Statistics::writeMetrics(MetricsFilename)) {
+    llvm::errs() << "\n" << sHipify << sError << "writing metrics to \"" << MetricsFilename << "\" failed" << "\n";
+    Result = 1;
   }
   return Result;
 }
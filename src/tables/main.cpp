@@ -0,0 +1,121 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/CommandLine.h"
+#include "CUDA2HIP.h"
+#include "Options.h"
+#include "CUDA2HIP_Scripting.h"
+#include "LLVMCompatSupport.h"
+#include "MappingDB.h"
+#include "MappingOverlay.h"
+
+using namespace llvm;
+
+// hipify-tables: the build-time generator of hipify-perl, the Python map, the documentation, and the mapping database from the hipify-clang's tables
+
+cl::OptionCategory TablesCategory("hipify-tables options");
+
+cl::opt<std::string, true> OutputHipifyPerlDirOption("o-hipify-perl-dir",
+  cl::location(OutputHipifyPerlDir),
+  cl::desc("Output directory for hipify-perl script"),
+  cl::value_desc("directory"),
+  cl::Required,
+  cl::cat(TablesCategory));
+
+cl::opt<bool, true> GeneratePerlModulesOption("perl-modules",
+  cl::location(GeneratePerlModules),
+  cl::desc("Generate hipify-perl as a driver script and per-API modules"),
+  cl::cat(TablesCategory));
+
+cl::opt<std::string, true> OutputPythonMapDirOption("o-python-map-dir",
+  cl::location(OutputPythonMapDir),
+  cl::desc("Output directory for Python map"),
+  cl::value_desc("directory"),
+  cl::Required,
+  cl::cat(TablesCategory));
+
+cl::opt<std::string, true> OutputDirOption("o-dir",
+  cl::location(OutputDir),
+  cl::desc("Output directory for documentation"),
+  cl::value_desc("directory"),
+  cl::Required,
+  cl::cat(TablesCategory));
+
+cl::opt<std::string> OutputMappingDB("o-mapping-db",
+  cl::desc("Output file for the binary mapping database"),
+  cl::value_desc("file"),
+  cl::cat(TablesCategory));
+
+cl::opt<std::string, true> DocFormatOption("doc-format",
+  cl::location(DocFormat),
+  cl::desc("Documentation format: 'full' (default), 'strict', or 'compact'"),
+  cl::value_desc("value"),
+  cl::cat(TablesCategory));
+
+cl::opt<std::string> MappingOverlay("mapping-overlay",
+  cl::desc("Load the additional CUDA to HIP mappings from the tab-separated file"),
+  cl::value_desc("file"),
+  cl::cat(TablesCategory));
+
+cl::opt<bool, true> SaveTempsOption("save-temps",
+  cl::location(SaveTemps),
+  cl::desc("Save temporary files"),
+  cl::cat(TablesCategory));
+
+// Not options of hipify-tables: the shared tables' checks depend on them
+cl::opt<bool, true> TranslateToRocOption("roc",
+  cl::location(TranslateToRoc),
+  cl::ReallyHidden);
+
+cl::opt<bool, true> TranslateToMIOpenOption("miopen",
+  cl::location(TranslateToMIOpen),
+  cl::ReallyHidden);
+
+int main(int argc, const char **argv) {
+  cl::HideUnrelatedOptions(TablesCategory);
+#if LLVM_VERSION_MAJOR > 5
+  cl::SetVersionPrinter([](raw_ostream &) { errs() << "HIP version " << sHIP_version << "\n"; });
+#else
+  cl::SetVersionPrinter([]() { errs() << "HIP version " << sHIP_version << "\n"; });
+#endif
+  cl::ParseCommandLineOptions(argc, argv, "hipify-tables: generates hipify-perl, the Python map, the documentation, and the mapping database in a single run\n");
+  if (!MappingOverlay.empty()) {
+    std::string sErrorMessage;
+    if (!loadMappingOverlay(MappingOverlay, sErrorMessage)) {
+      errs() << "\n" << sHipify << sError << sErrorMessage << "\n";
+      return 1;
+    }
+  }
+  if (!perl::generate(true)) return 1;
+  if (!python::generate(true)) return 1;
+  if (!doc::generate(true, true)) return 1;
+  if (!OutputMappingDB.empty()) {
+    std::string sErrorMessage;
+    if (!MappingDB::write(OutputMappingDB, sErrorMessage)) {
+      errs() << "\n" << sHipify << sError << sErrorMessage << "\n";
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,75 @@
+/*
+Copyright (c) 2015 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+// A test driver of libhipify: creates a single Hipifier and hipifies the files from the threads, one thread per file,
+// and then prints the hipified files in the order of the arguments.
+// Usage: library_threads [--cuda-path=<dir>] [-I<dir>] <file>...
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include "libhipify/libhipify.h"
+
+int main(int argc, const char **argv) {
+  libhipify::Options options;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.compare(0, 12, "--cuda-path=") == 0) options.sCudaPath = arg.substr(12);
+    else if (arg.compare(0, 2, "-I") == 0) options.includeDirs.push_back(arg.substr(2));
+    else files.push_back(arg);
+  }
+  std::string sErrorMessage;
+  std::unique_ptr<libhipify::Hipifier> hipifier = libhipify::Hipifier::create(options, sErrorMessage);
+  if (!hipifier) {
+    std::cerr << "error: " << sErrorMessage << "\n";
+    return 1;
+  }
+  std::vector<std::string> sources(files.size());
+  for (size_t i = 0; i < files.size(); ++i) {
+    std::ifstream in(files[i], std::ios_base::binary);
+    if (!in) {
+      std::cerr << "error: can't read " << files[i] << "\n";
+      return 1;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    sources[i] = buffer.str();
+  }
+  std::vector<libhipify::Result> results(files.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < files.size(); ++i) {
+    threads.emplace_back([&, i]() { results[i] = hipifier->hipify(sources[i], files[i]); });
+  }
+  for (auto &thread : threads) thread.join();
+  int status = 0;
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (!results[i].bSucceeded) {
+      std::cerr << "error: " << files[i] << " failed to be hipified\n";
+      status = 1;
+    }
+    std::cout << results[i].hipified;
+  }
+  return status;
+}
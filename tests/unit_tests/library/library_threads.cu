@@ -0,0 +1,16 @@
+// RUN: echo "#include <cuda_runtime.h>" > "%t.cu"
+// RUN: echo "cudaError_t reset() { return cudaDeviceReset(); }" >> "%t.cu"
+// RUN: %library_threads %hipify_args "%s" "%t.cu" | sed -Ee 's|//.+|// |g' | FileCheck "%s"
+
+// A single Hipifier hipifies this file and the one above from two threads.
+// CHECK: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+
+int main() {
+  // CHECK: hipDeviceSynchronize();
+  cudaDeviceSynchronize();
+  return 0;
+}
+
+// CHECK: #include <hip/hip_runtime.h>
+// CHECK: hipError_t reset() { return hipDeviceReset(); }
@@ -0,0 +1,16 @@
+// RUN: rm -rf "%t" && mkdir -p "%t"
+// RUN: echo '[{"directory": "%/S", "arguments": ["nvcc", "-DFROM_ARGUMENTS", "-c", "%/s"], "file": "%/s"}]' > "%t/compile_commands.json"
+// RUN: hipify -p "%t" -o-dir="%t" --skip-excluded-preprocessor-conditional-blocks %hipify_args
+// RUN: sed -Ee 's|//.+|// |g' "%t/database-arguments.cu.hip" | FileCheck "%s"
+
+// CHECK: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+
+int main() {
+  // The code is hipified only if the "arguments" of the entry are applied.
+#if defined(FROM_ARGUMENTS)
+  // CHECK: hipDeviceSynchronize();
+  cudaDeviceSynchronize();
+#endif
+  return 0;
+}
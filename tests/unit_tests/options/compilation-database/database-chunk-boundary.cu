@@ -0,0 +1,17 @@
+// RUN: rm -rf "%t" && mkdir -p "%t"
+// RUN: %python "%S/write_padded_database.py" "%t/compile_commands.json" "%/S" "%/s" -DFROM_ARGUMENTS
+// RUN: hipify -p "%t" -o-dir="%t" --skip-excluded-preprocessor-conditional-blocks %hipify_args
+// RUN: sed -Ee 's|//.+|// |g' "%t/database-chunk-boundary.cu.hip" | FileCheck "%s"
+
+// The entry is longer than the 1 MiB chunk of the database, so it is continued in the next chunk,
+// and its padding (escaped quotes and braces) crosses the chunk boundary.
+// CHECK: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+
+int main() {
+#if defined(FROM_ARGUMENTS)
+  // CHECK: hipDeviceSynchronize();
+  cudaDeviceSynchronize();
+#endif
+  return 0;
+}
@@ -0,0 +1,16 @@
+// RUN: rm -rf "%t" && mkdir -p "%t"
+// RUN: echo '[{"directory": "%/S", "command": "nvcc -DFROM_\u0043OMMAND=\"1 + 1\" -c database-command.cu", "file": "database-command.cu"}]' > "%t/compile_commands.json"
+// RUN: hipify -p "%t" -o-dir="%t" --skip-excluded-preprocessor-conditional-blocks %hipify_args
+// RUN: sed -Ee 's|//.+|// |g' "%t/database-command.cu.hip" | FileCheck "%s"
+
+// CHECK: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+
+int main() {
+  // The code is hipified only if the "command" of the entry is decoded (\u0043 is C) and tokenized.
+#if FROM_COMMAND == 2
+  // CHECK: hipDeviceSynchronize();
+  cudaDeviceSynchronize();
+#endif
+  return 0;
+}
@@ -0,0 +1,16 @@
+// RUN: rm -rf "%t" && mkdir -p "%t"
+// RUN: echo "-DFROM_COMPILE_FLAGS" > "%t/compile_flags.txt"
+// RUN: hipify -p "%t" "%s" -o-dir="%t" --skip-excluded-preprocessor-conditional-blocks %hipify_args
+// RUN: sed -Ee 's|//.+|// |g' "%t/database-compile-flags.cu.hip" | FileCheck "%s"
+
+// Without compile_commands.json, the compilation database (compile_flags.txt) is loaded by clang.
+// CHECK: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+
+int main() {
+#if defined(FROM_COMPILE_FLAGS)
+  // CHECK: hipDeviceSynchronize();
+  cudaDeviceSynchronize();
+#endif
+  return 0;
+}
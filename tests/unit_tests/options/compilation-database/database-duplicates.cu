@@ -0,0 +1,23 @@
+// RUN: rm -rf "%t" && mkdir -p "%t"
+// RUN: echo '[{"directory": "%/S", "arguments": ["nvcc", "-DFIRST", "%/s"], "file": "%/s"}, {"directory": "%/S", "arguments": ["nvcc", "-DSECOND", "database-duplicates.cu"], "file": "./database-duplicates.cu"}]' > "%t/compile_commands.json"
+// RUN: hipify -p "%t" -o-dir="%t" --skip-excluded-preprocessor-conditional-blocks --stats-format=jsonl -o-stats=stats.jsonl %hipify_args
+// RUN: sed -Ee 's|//.+|// |g' "%t/database-duplicates.cu.hip" | FileCheck "%s"
+// RUN: FileCheck "%s" --check-prefix=JSONL --input-file="%t/stats.jsonl"
+
+// The file of both entries is hipified once, with the command of the first entry.
+// JSONL: "aggregate":true,{{.*}}"processed_files":1,
+
+// CHECK: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+
+int main() {
+#if defined(FIRST)
+  // CHECK: hipDeviceSynchronize();
+  cudaDeviceSynchronize();
+#endif
+#if defined(SECOND)
+  // CHECK: cudaDeviceReset();
+  cudaDeviceReset();
+#endif
+  return 0;
+}
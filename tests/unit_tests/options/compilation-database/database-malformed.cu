@@ -0,0 +1,7 @@
+// RUN: rm -rf "%t" && mkdir -p "%t"
+// RUN: echo '[{"directory": "%/S", "file": "%/s", "command": "nvcc -c %/s"' > "%t/compile_commands.json"
+// RUN: not hipify -p "%t" -o-dir="%t" %hipify_args 2>&1 | FileCheck "%s"
+
+// The unterminated database is reported once it is read to the end.
+// CHECK: error: malformed JSON: compilation database: {{.*}}compile_commands.json
+#include <cuda_runtime.h>
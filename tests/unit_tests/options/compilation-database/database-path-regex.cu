@@ -0,0 +1,17 @@
+// RUN: rm -rf "%t" && mkdir -p "%t"
+// RUN: echo "#include <cuda_runtime.h>" > "%t/excluded.cu"
+// RUN: echo "#include <cuda_runtime.h>" > "%t/not_included.cu"
+// RUN: echo '[{"directory": "%/t", "file": "excluded.cu", "command": "nvcc -c excluded.cu"}, {"directory": "%/t", "file": "not_included.cu", "command": "nvcc -c not_included.cu"}, {"directory": "%/S", "file": "%/s", "command": "nvcc -c %/s"}]' > "%t/compile_commands.json"
+// RUN: hipify -p "%t" -o-dir="%t" --include-path-regex='/(database-path-regex|excluded)\.cu$' --exclude-path-regex='/excluded\.cu$' %hipify_args
+// RUN: sed -Ee 's|//.+|// |g' "%t/database-path-regex.cu.hip" | FileCheck "%s"
+// RUN: not ls "%t/excluded.cu.hip"
+// RUN: not ls "%t/not_included.cu.hip"
+
+// CHECK: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+
+int main() {
+  // CHECK: hipDeviceSynchronize();
+  cudaDeviceSynchronize();
+  return 0;
+}
@@ -0,0 +1,10 @@
+# Write the compilation database of a single entry, which is padded to be longer than the 1 MiB chunk
+# of hipify-clang's reader: write_padded_database.py <database> <directory> <file> [<argument>...]
+import json
+import sys
+
+database, directory, file = sys.argv[1:4]
+entry = ('{"directory": ' + json.dumps(directory) + ', "padding": ' + json.dumps('\\"}]' * 300000) +
+         ', "arguments": ' + json.dumps(['nvcc'] + sys.argv[4:] + ['-c', file]) + ', "file": ' + json.dumps(file) + '}')
+with open(database, 'w') as f:
+    f.write('[\n  ' + entry + '\n]\n')
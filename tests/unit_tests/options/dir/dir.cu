@@ -0,0 +1,19 @@
+// RUN: rm -rf "%t" && mkdir -p "%t/src/sub" "%t/src/third_party" "%t/out"
+// RUN: cp "%s" "%t/src/sub/dir.cu"
+// RUN: echo "#include <cuda_runtime.h>" > "%t/src/third_party/ignored.cu"
+// RUN: echo "#include <cuda_runtime.h>" > "%t/src/notes.txt"
+// RUN: hipify --dir="%t/src" --dir-ignore=third_party -o-dir="%t/out" %hipify_args -- %clang_args
+// RUN: sed -Ee 's|//.+|// |g' "%t/out/sub/dir.cu.hip" | FileCheck "%s"
+// RUN: not ls "%t/out/third_party"
+// RUN: not ls "%t/out/notes.txt.hip"
+
+// The walked tree is mirrored in the output directory; the ignored directory and the files
+// with the extensions other than the default ones are skipped.
+// CHECK: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+
+int main() {
+  // CHECK: hipDeviceSynchronize();
+  cudaDeviceSynchronize();
+  return 0;
+}
@@ -0,0 +1,15 @@
+// RUN: rm -rf "%t.nl" "%t.nul" && mkdir -p "%t.nl" "%t.nul"
+// RUN: echo "%s" | hipify --files-from=- -o-dir="%t.nl" %hipify_args -- %clang_args
+// RUN: sed -Ee 's|//.+|// |g' "%t.nl/files-from.cu.hip" | FileCheck "%s"
+// A list separated by NULs, as printed by find -print0, has no newlines at all.
+// RUN: printf '%%s\0' "%s" | hipify --files-from=- -o-dir="%t.nul" %hipify_args -- %clang_args
+// RUN: sed -Ee 's|//.+|// |g' "%t.nul/files-from.cu.hip" | FileCheck "%s"
+
+// CHECK: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+
+int main() {
+  // CHECK: hipDeviceSynchronize();
+  cudaDeviceSynchronize();
+  return 0;
+}
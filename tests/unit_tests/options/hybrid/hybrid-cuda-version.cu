@@ -0,0 +1,23 @@
+// RUN: hipify "%s" -o="%t.cu" --hybrid --cuda-version=8.0 --stats-format=jsonl -o-stats="%t.jsonl" %hipify_args -- %clang_args 2> "%t.err"
+// RUN: sed -Ee 's|//.+|// |g' "%t.cu" | FileCheck "%s"
+// RUN: FileCheck "%s" --check-prefix=ENGINE --input-file="%t.err"
+// RUN: FileCheck "%s" --check-prefix=JSONL --input-file="%t.jsonl"
+// RUN: not hipify "%s" -o="%t.cu" --hybrid --include-driven-renames %hipify_args -- %clang_args 2>&1 | FileCheck "%s" --check-prefix=CONFLICT
+
+// There are no constructs needing the AST in this file, so it is hipified by the lexical engine,
+// which keeps the identifiers introduced after the target CUDA version, as clang does.
+// ENGINE: file '{{.*}}hybrid-cuda-version.cu' hipified by the lexical engine
+// JSONL: "converted_refs":2,"unconverted_refs":0,
+// CONFLICT: both -include-driven-renames and -hybrid options are specified
+
+// CHECK: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+
+int main() {
+  // cudaStreamCaptureStatus and cudaStreamCaptureStatusNone appeared in CUDA 10.0.
+  // CHECK: cudaStreamCaptureStatus status = cudaStreamCaptureStatusNone;
+  cudaStreamCaptureStatus status = cudaStreamCaptureStatusNone;
+  // CHECK: hipDeviceSynchronize();
+  cudaDeviceSynchronize();
+  return status;
+}
@@ -0,0 +1,15 @@
+// RUN: rm -rf "%t" && mkdir -p "%t/tmp"
+// RUN: cp "%s" "%t/hybrid-inplace.cu"
+// RUN: hipify "%t/hybrid-inplace.cu" -inplace --hybrid --temp-dir="%t/tmp" %hipify_args -- %clang_args
+// RUN: sed -Ee 's|//.+|// |g' "%t/hybrid-inplace.cu" | FileCheck "%s"
+// RUN: not ls "%t/tmp/hybrid-inplace.cu.hip"
+
+// The lexical engine hipifies the input in place through a temporary file, which is removed afterwards.
+// CHECK: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+
+int main() {
+  // CHECK: hipDeviceSynchronize();
+  cudaDeviceSynchronize();
+  return 0;
+}
@@ -0,0 +1,14 @@
+// RUN: %run_test hipify "%s" "%t" %hipify_args 1 --hybrid %clang_args
+// CHECK: #include <hip/hip_runtime.h>
+#include <cuda.h>
+
+// There are no constructs needing the AST in this file, so it is hipified by the lexical engine,
+// which joins the lines of the call below by removing its argument, so the output has fewer lines.
+void occupancy(hipFunction_t function) {
+  int gridSize = 0, blockSize = 0;
+  // CHECK: hipModuleOccupancyMaxPotentialBlockSize(&gridSize, &blockSize, function, 0, 0);
+  hipModuleOccupancyMaxPotentialBlockSize(&gridSize, &blockSize, function,
+    0, 0, 0);
+  // CHECK: hipInit(0);
+  cuInit(0);
+}
@@ -0,0 +1,37 @@
+// RUN: %run_test hipify "%s" "%t" %hipify_args 1 --hybrid %clang_args
+// CHECK: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+#include <stdio.h>
+
+// There are no constructs needing the AST in this file,
+// so it is hipified by the lexical engine.
+int main(int argc, char *argv[])
+{
+    const int numElements = 10;
+    float A[numElements];
+    float *d_A = nullptr;
+    for (int i = 0; i < numElements; i++) {
+        A[i] = 1.0f;
+    }
+    // CHECK: hipError_t err = hipMalloc(&d_A, numElements * sizeof(float));
+    cudaError_t err = cudaMalloc(&d_A, numElements * sizeof(float));
+    // CHECK: if (err != hipSuccess) {
+    if (err != cudaSuccess) {
+        // CHECK: printf("%s\n", hipGetErrorString(err));
+        printf("%s\n", cudaGetErrorString(err));
+        return 1;
+    }
+    // CHECK: hipStream_t stream;
+    cudaStream_t stream;
+    // CHECK: hipStreamCreate(&stream);
+    cudaStreamCreate(&stream);
+    // CHECK: hipMemcpyAsync(d_A, A, numElements * sizeof(float), hipMemcpyHostToDevice, stream);
+    cudaMemcpyAsync(d_A, A, numElements * sizeof(float), cudaMemcpyHostToDevice, stream);
+    // CHECK: hipStreamSynchronize(stream);
+    cudaStreamSynchronize(stream);
+    // CHECK: hipStreamDestroy(stream);
+    cudaStreamDestroy(stream);
+    // CHECK: hipFree(d_A);
+    cudaFree(d_A);
+    return 0;
+}
@@ -0,0 +1,4 @@
+// The helper header of included.cu, which includes cuSPARSE header transitively.
+#pragma once
+
+#include "cusparse.h"
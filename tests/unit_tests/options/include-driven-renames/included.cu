@@ -0,0 +1,24 @@
+// RUN: %run_test hipify "%s" "%t" %hipify_args 1 --include-driven-renames %clang_args
+
+// CHECK: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+// cuBLAS header is included directly.
+// CHECK: #include "hipblas.h"
+#include "cublas_v2.h"
+// cuSPARSE header is included through the local header, which isn't hipified.
+// CHECK: #include "include-driven-renames.h"
+#include "include-driven-renames.h"
+
+int main() {
+  // CHECK: hipblasHandle_t blasHandle = nullptr;
+  cublasHandle_t blasHandle = nullptr;
+  // CHECK: hipblasCreate(&blasHandle);
+  cublasCreate(&blasHandle);
+  // CHECK: hipsparseHandle_t sparseHandle = nullptr;
+  cusparseHandle_t sparseHandle = nullptr;
+  // CHECK: hipsparseCreate(&sparseHandle);
+  cusparseCreate(&sparseHandle);
+  // CHECK: hipDeviceSynchronize();
+  cudaDeviceSynchronize();
+  return 0;
+}
@@ -0,0 +1,31 @@
+// RUN: %run_test hipify "%s" "%t" %hipify_args 1 --include-driven-renames %clang_args
+// RUN: hipify "%s" -o="%t.all.cu" %hipify_args -- %clang_args
+// RUN: sed -Ee 's|//.+|// |g' "%t.all.cu" | FileCheck "%s" --check-prefix=ALL
+
+// Neither cuBLAS nor cuSPARSE header is included, so their identifiers are the program's own ones,
+// which are left as is with --include-driven-renames and converted without it.
+
+// CHECK: #include <hip/hip_runtime.h>
+// ALL: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+
+// CHECK: typedef int cublasHandle_t;
+// ALL: typedef int hipblasHandle_t;
+typedef int cublasHandle_t;
+// CHECK: typedef int cusparseHandle_t;
+// ALL: typedef int hipsparseHandle_t;
+typedef int cusparseHandle_t;
+
+int main() {
+  // CHECK: cublasHandle_t blasHandle = 0;
+  // ALL: hipblasHandle_t blasHandle = 0;
+  cublasHandle_t blasHandle = 0;
+  // CHECK: cusparseHandle_t sparseHandle = 0;
+  // ALL: hipsparseHandle_t sparseHandle = 0;
+  cusparseHandle_t sparseHandle = 0;
+  // The Runtime API is always converted.
+  // CHECK: hipDeviceSynchronize();
+  // ALL: hipDeviceSynchronize();
+  cudaDeviceSynchronize();
+  return blasHandle + sparseHandle;
+}
@@ -0,0 +1,19 @@
+// RUN: rm -rf "%t" && mkdir -p "%t/perl" "%t/python" "%t/doc"
+// RUN: printf 'cudaDeviceReset\thipDeviceResetFromDatabase\tCONV_DEVICE\tAPI_RUNTIME\n' > "%t/overlay.tsv"
+// RUN: %tables -o-hipify-perl-dir="%t/perl" -o-python-map-dir="%t/python" -o-dir="%t/doc" -o-mapping-db="%t/mappings.db" --mapping-overlay="%t/overlay.tsv"
+// RUN: %run_test hipify "%s" "%t/mapping-db.cu" %hipify_args 1 --mapping-db="%t/mappings.db" %clang_args
+// RUN: not hipify "%s" -o="%t/wrong.cu" --mapping-db="%t/overlay.tsv" %hipify_args -- %clang_args 2>&1 | FileCheck "%s" --check-prefix=ERROR
+
+// ERROR: error: mapping database: {{.*}}overlay.tsv: not a mapping database
+
+// CHECK: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+
+int main() {
+  // The overlay is given to hipify-tables only, so the rename is looked up in the database.
+  // CHECK: hipDeviceResetFromDatabase();
+  cudaDeviceReset();
+  // CHECK: hipDeviceSynchronize();
+  cudaDeviceSynchronize();
+  return 0;
+}
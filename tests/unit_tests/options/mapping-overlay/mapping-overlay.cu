@@ -0,0 +1,18 @@
+// RUN: printf '# CUDA\tHIP\tconversion\tAPI\ncudaDeviceReset\thipDeviceResetOverlaid\tCONV_DEVICE\tAPI_RUNTIME\n' > "%t.tsv"
+// RUN: %run_test hipify "%s" "%t" %hipify_args 1 --mapping-overlay="%t.tsv" %clang_args
+// RUN: printf 'cudaDeviceReset\thipDeviceReset\tCONV_UNKNOWN\tAPI_RUNTIME\n' > "%t.bad.tsv"
+// RUN: not hipify "%s" -o="%t.bad" --mapping-overlay="%t.bad.tsv" %hipify_args -- %clang_args 2>&1 | FileCheck "%s" --check-prefix=ERROR
+
+// ERROR: error: {{.*}}.bad.tsv:1: unknown conversion type: CONV_UNKNOWN
+
+// CHECK: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+
+int main() {
+  // The mapping of the overlay takes precedence over the built-in one.
+  // CHECK: hipDeviceResetOverlaid();
+  cudaDeviceReset();
+  // CHECK: hipDeviceSynchronize();
+  cudaDeviceSynchronize();
+  return 0;
+}
@@ -0,0 +1,22 @@
+// RUN: rm -rf "%t.dir" && mkdir -p "%t.dir"
+// RUN: echo "#include <cuda_runtime.h>" > "%t.dir/quick.cu"
+// RUN: hipify "%s" "%t.dir/quick.cu" -o-dir="%t.dir" --per-file-timeout=1 --timeout-lexical-retry --stats-format=jsonl -o-stats=stats.jsonl %hipify_args -- %clang_args -fconstexpr-steps=2147483647
+// RUN: sed -Ee 's|//.+|// |g' "%t.dir/timeout-lexical-retry.cu.hip" | FileCheck "%s"
+// RUN: FileCheck "%s" --check-prefix=JSONL --input-file="%t.dir/stats.jsonl"
+
+// The worker of this file is killed after a second of the constant evaluation below, and then the file is hipified by the lexical engine.
+// JSONL: "status":"timeout_lexical"
+// JSONL: "status":"ok"
+// JSONL: "aggregate":true,{{.*}}"processed_files":2,"timed_out_files":1}
+
+// CHECK: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+
+constexpr unsigned long long fib(unsigned n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }
+static_assert(fib(60) > 0, "evaluated for much longer than the timeout");
+
+int main() {
+  // CHECK: hipDeviceSynchronize();
+  cudaDeviceSynchronize();
+  return 0;
+}
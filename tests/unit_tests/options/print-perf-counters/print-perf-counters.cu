@@ -0,0 +1,27 @@
+// RUN: rm -rf "%t.dir" && mkdir -p "%t.dir"
+// RUN: hipify "%s" -o="%t.dir/out.cu" --print-perf-counters %hipify_args -- %clang_args 2> "%t.dir/terminal.txt"
+// RUN: FileCheck "%s" --check-prefix=TERMINAL --input-file="%t.dir/terminal.txt"
+// RUN: hipify "%s" -o-dir="%t.dir" --print-perf-counters -print-stats-csv -o-stats=stats.csv %hipify_args -- %clang_args 2> "%t.dir/csv-terminal.txt"
+// RUN: FileCheck "%s" --check-prefix=CSV --input-file="%t.dir/stats.csv"
+// RUN: not grep "perf counters" "%t.dir/csv-terminal.txt"
+// RUN: hipify "%s" -o-dir="%t.dir" --print-perf-counters --stats-format=jsonl -o-stats=stats.jsonl %hipify_args -- %clang_args 2> "%t.dir/jsonl-terminal.txt"
+// RUN: FileCheck "%s" --check-prefix=JSONL --input-file="%t.dir/stats.jsonl"
+// RUN: not grep "perf counters" "%t.dir/jsonl-terminal.txt"
+
+// Without the statistics file, the perf counters are printed to the terminal.
+// TERMINAL: [HIPIFY] info: file '{{.*}}print-perf-counters.cu' perf counters:
+// TERMINAL: rename lookups: {{[1-9][0-9]*}}
+
+// With the statistics file, the perf counters go into it only.
+// CSV: file '{{.*}}print-perf-counters.cu' perf counters:
+// CSV-NEXT: Perf counter;Count
+// CSV: rename lookups;{{[1-9][0-9]*}}
+
+// JSONL: "perf":{"tokens_lexed":{{[0-9]+}},"rename_lookups":{{[1-9][0-9]*}},
+
+#include <cuda_runtime.h>
+
+int main() {
+  cudaDeviceSynchronize();
+  return 0;
+}
@@ -0,0 +1,21 @@
+// RUN: rm -rf "%t.dir" && mkdir -p "%t.dir"
+// RUN: hipify "%s" -o-dir="%t.dir" --stats-format=jsonl -o-stats=stats.jsonl %hipify_args -- %clang_args
+// RUN: FileCheck "%s" --check-prefix=JSONL --input-file="%t.dir/stats.jsonl" --implicit-check-not='"aggregate"'
+// RUN: echo "#include <cuda_runtime.h>" > "%t.dir/second.cu"
+// RUN: hipify "%s" "%t.dir/second.cu" -o-dir="%t.dir" --stats-format=jsonl -o-stats=stats.jsonl %hipify_args -- %clang_args
+// RUN: FileCheck "%s" --check-prefix=MULTIPLE --input-file="%t.dir/stats.jsonl"
+
+// A single source file gets its own record only, without the aggregate one.
+// JSONL: {"file":"{{.*}}stats-jsonl.cu","status":"ok","converted_refs":{{[1-9][0-9]*}},"unconverted_refs":0,
+
+// Multiple source files are followed by the aggregate record.
+// MULTIPLE: "status":"ok"
+// MULTIPLE: "status":"ok"
+// MULTIPLE: "aggregate":true,{{.*}}"processed_files":2,
+
+#include <cuda_runtime.h>
+
+int main() {
+  cudaDeviceSynchronize();
+  return 0;
+}
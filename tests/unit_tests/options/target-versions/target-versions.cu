@@ -0,0 +1,26 @@
+// RUN: hipify "%s" -o="%t.cuda.cu" --cuda-version=8.0 %hipify_args -- %clang_args
+// RUN: sed -Ee 's|//.+|// |g' "%t.cuda.cu" | FileCheck "%s" --check-prefixes=COMMON,CUDA80
+// RUN: hipify "%s" -o="%t.hip.cu" --hip-version=3.0 %hipify_args -- %clang_args
+// RUN: sed -Ee 's|//.+|// |g' "%t.hip.cu" | FileCheck "%s" --check-prefixes=COMMON,HIP30
+
+// COMMON: #include <hip/hip_runtime.h>
+#include <cuda_runtime.h>
+
+__global__ void kernel() {}
+
+int main() {
+  int value = 0, priority = 0;
+  cudaStream_t stream = nullptr;
+  // cudaDeviceGetP2PAttribute and cudaDevP2PAttrPerformanceRank appeared in CUDA 8.0, and their HIP counterparts in HIP 3.8.
+  // CUDA80: hipDeviceGetP2PAttribute(&value, hipDevP2PAttrPerformanceRank, 0, 1);
+  // HIP30: cudaDeviceGetP2PAttribute(&value, cudaDevP2PAttrPerformanceRank, 0, 1);
+  cudaDeviceGetP2PAttribute(&value, cudaDevP2PAttrPerformanceRank, 0, 1);
+  // cudaLaunchCooperativeKernel appeared in CUDA 9.0, and hipLaunchCooperativeKernel in HIP 2.6.
+  // CUDA80: cudaLaunchCooperativeKernel((void*)kernel, dim3(1), dim3(1), nullptr, 0, stream);
+  // HIP30: hipLaunchCooperativeKernel((void*)kernel, dim3(1), dim3(1), nullptr, 0, stream);
+  cudaLaunchCooperativeKernel((void*)kernel, dim3(1), dim3(1), nullptr, 0, stream);
+  // Both cudaStreamGetPriority and hipStreamGetPriority appeared before the target versions.
+  // COMMON: hipStreamGetPriority(stream, &priority);
+  cudaStreamGetPriority(stream, &priority);
+  return 0;
+}
@@ -1,4 +1,5 @@
 // RUN: %run_test hipify "%s" "%t" %hipify_args 2 --skip-excluded-preprocessor-conditional-blocks --experimental %clang_args -D__CUDA_API_VERSION_INTERNAL
+// RUN: %fast --experimental "%s" | sed -Ee 's|//.+|// |g' | FileCheck "%s"
 
 // CHECK: #include <hip/hip_runtime.h>
 #include <cuda.h>